@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+#include <util/crc16.h>
+
+#include "BinaryFrameParser.h"
+
+/**
+ * Constructor.
+ *
+ * @param fieldsByNumber the fields by field number, field 1 at index 0. Entries may be NULL for unused numbers.
+ * @param fieldCount the number of entries in fieldsByNumber.
+ */
+BinaryFrameParser::BinaryFrameParser(FieldConfiguration *const *fieldsByNumber, uint8_t fieldCount)
+{
+  this->fieldsByNumber = fieldsByNumber;
+  this->fieldCount = fieldCount;
+  resetCounters();
+  reset();
+}
+
+/**
+ * Parses the next received byte.
+ *
+ * @param received the received byte.
+ * @return what the byte completed, one of the MESSAGE_* constants.
+ */
+uint8_t BinaryFrameParser::parse(uint8_t received)
+{
+  if (state != EXPECT_SYNC)
+  {
+    frameBytes[frameByteCount++] = received;
+  }
+  switch (state)
+  {
+    case EXPECT_SYNC:
+      if (received == BINARY_FRAME_SYNC)
+      {
+        state = EXPECT_HEADER;
+        crc = 0;
+        frameByteCount = 0;
+      }
+      else if (++invalidByteCount >= BINARY_FRAME_MAX_INVALID_BYTES)
+      {
+        // no frames are received any more, presumably the sender sends ASCII messages again
+        return MESSAGE_ASCII_MODE_REQUEST;
+      }
+      break;
+    case EXPECT_HEADER:
+      header = received;
+      crc = _crc8_ccitt_update(crc, received);
+      state = EXPECT_SEQUENCE_NUMBER;
+      break;
+    case EXPECT_SEQUENCE_NUMBER:
+      sequenceNumber = received;
+      crc = _crc8_ccitt_update(crc, received);
+      encodedValue = 0;
+      valueByteCount = 0;
+      state = EXPECT_VALUE;
+      break;
+    case EXPECT_VALUE:
+      if (valueByteCount == BINARY_FRAME_MAX_VALUE_BYTES - 1 && received > 0x03)
+      {
+        // the last value byte carries the 2 most significant bits of the 16 bit value, and no further byte may follow
+        corruptedFrameCount++;
+        invalidByteCount++;
+        return resync();
+      }
+      encodedValue |= (uint16_t) (received & 0x7F) << (7 * valueByteCount);
+      valueByteCount++;
+      crc = _crc8_ccitt_update(crc, received);
+      if (!(received & 0x80))
+      {
+        state = EXPECT_CRC;
+      }
+      break;
+    case EXPECT_CRC:
+      state = EXPECT_SYNC;
+      if (received != crc)
+      {
+        corruptedFrameCount++;
+        invalidByteCount++;
+        return resync();
+      }
+      invalidByteCount = 0;
+      if (sequenceNumberKnown && (int8_t) (sequenceNumber - expectedSequenceNumber) < 0)
+      {
+        // a duplicate or retransmitted frame, or a sender which restarted its numbering: nothing was lost
+        return dispatch();
+      }
+      if (sequenceNumberKnown)
+      {
+        lostFrameCount += (uint8_t) (sequenceNumber - expectedSequenceNumber);
+      }
+      sequenceNumberKnown = true;
+      expectedSequenceNumber = sequenceNumber + 1;
+      return dispatch();
+  }
+  return MESSAGE_NONE;
+}
+
+/**
+ * Parses the bytes received after the sync byte of a corrupted frame again, starting with the sync search,
+ * so that the sync byte of a following frame which was taken as part of the corrupted frame is found.
+ * The parsed bytes are shorter than the corrupted frame, so a further corrupted frame among them ends the recursion.
+ *
+ * @return what the parsed bytes completed, one of the MESSAGE_* constants.
+ */
+uint8_t BinaryFrameParser::resync()
+{
+  uint8_t bytes[BINARY_FRAME_MAX_LENGTH - 1];
+  uint8_t byteCount = frameByteCount;
+  memcpy(bytes, frameBytes, byteCount);
+  state = EXPECT_SYNC;
+  uint8_t result = MESSAGE_NONE;
+  for (uint8_t i = 0; i < byteCount; i++)
+  {
+    uint8_t byteResult = parse(bytes[i]);
+    if (byteResult != MESSAGE_NONE)
+    {
+      result = byteResult;
+    }
+  }
+  return result;
+}
+
+/**
+ * Passes the value of the received frame to its field.
+ *
+ * @return what the frame completed, one of the MESSAGE_* constants.
+ */
+uint8_t BinaryFrameParser::dispatch()
+{
+  uint8_t fieldNumber = header & 0x0F;
+  if (fieldNumber == 0)
+  {
+    return MESSAGE_ASCII_MODE_REQUEST;
+  }
+  if (fieldNumber > fieldCount || fieldsByNumber[fieldNumber - 1] == NULL)
+  {
+    return MESSAGE_NONE;
+  }
+  int16_t value = (int16_t) ((encodedValue >> 1) ^ -(encodedValue & 0x01));
+  char text[BINARY_FRAME_MAX_TEXT_LENGTH];
+  uint8_t length = formatValue(value, (header >> 4) & 0x03, (header >> 6) + 1, text);
+  fieldsByNumber[fieldNumber - 1]->setValue(text, length);
+  return MESSAGE_FIELD_VALUE;
+}
+
+/**
+ * Formats a fixed point value as text, e.g. 123 with 1 decimal place as "12.3".
+ *
+ * @param value the value * 10^decimalPlaces.
+ * @param decimalPlaces (0..3) the number of decimal places.
+ * @param integerDigits (1..4) the minimum number of digits before the decimal point, missing digits are filled with zeros.
+ * @param text receives the formatted value, at least BINARY_FRAME_MAX_TEXT_LENGTH characters, not zero terminated.
+ * @return the number of characters written to text.
+ */
+uint8_t BinaryFrameParser::formatValue(int16_t value, uint8_t decimalPlaces, uint8_t integerDigits, char *text)
+{
+  uint8_t length = 0;
+  uint16_t magnitude = value;
+  if (value < 0)
+  {
+    text[length++] = '-';
+    magnitude = 0U - (uint16_t) value; // -value would overflow for INT16_MIN
+  }
+  // the digits, least significant first
+  char digits[7];
+  uint8_t digitCount = 0;
+  do
+  {
+    digits[digitCount++] = '0' + magnitude % 10;
+    magnitude /= 10;
+  } while (magnitude > 0 || digitCount < decimalPlaces + integerDigits);
+  while (digitCount > 0)
+  {
+    if (digitCount == decimalPlaces)
+    {
+      text[length++] = '.';
+    }
+    text[length++] = digits[--digitCount];
+  }
+  return length;
+}
+
+/**
+ * Discards a partially received frame, forgets the last sequence number and the bytes received outside of valid frames.
+ */
+void BinaryFrameParser::reset()
+{
+  state = EXPECT_SYNC;
+  frameByteCount = 0;
+  invalidByteCount = 0;
+  sequenceNumberKnown = false;
+}
+
+/**
+ * Returns how many frames were dropped because of a wrong CRC or a too long value.
+ */
+uint16_t BinaryFrameParser::getCorruptedFrameCount()
+{
+  return corruptedFrameCount;
+}
+
+/**
+ * Returns how many frames were lost, as seen from gaps in the sequence numbers.
+ */
+uint16_t BinaryFrameParser::getLostFrameCount()
+{
+  return lostFrameCount;
+}
+
+/**
+ * Sets the counters returned by getCorruptedFrameCount() and getLostFrameCount() to zero.
+ */
+void BinaryFrameParser::resetCounters()
+{
+  corruptedFrameCount = 0;
+  lostFrameCount = 0;
+}
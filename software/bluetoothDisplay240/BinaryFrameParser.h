@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+#ifndef BINARY_FRAME_PARSER_H
+#define BINARY_FRAME_PARSER_H
+
+#include <Arduino.h>
+
+#include "FieldConfiguration.h"
+#include "MessageParser.h"
+
+#define BINARY_FRAME_SYNC 0xA5              // the first byte of each binary frame
+#define BINARY_FRAME_MAX_VALUE_BYTES 3      // the maximum length of the varint encoded value of a frame
+#define BINARY_FRAME_MAX_LENGTH (4 + BINARY_FRAME_MAX_VALUE_BYTES) // sync, header, sequence number, value and CRC
+#define BINARY_FRAME_MAX_INVALID_BYTES 32    // after this many bytes outside of valid frames, the parser requests to switch back to ASCII messages
+#define BINARY_FRAME_MAX_TEXT_LENGTH 9      // the maximum length of a value formatted as text, e.g. "-0032.768"
+
+/**
+ * Parses binary frames received via bluetooth, one byte at a time, without allocating memory.
+ *
+ * A frame consists of
+ * - the sync byte BINARY_FRAME_SYNC
+ * - the header byte: bits 0..3 the field number (1..15, 0 requests to switch back to ASCII messages),
+ *   bits 4..5 the number of decimal places of the value (0..3),
+ *   bits 6..7 the minimum number of digits before the decimal point minus one (0..3), e.g. 2 to display 45 as "045"
+ * - the sequence number (0..255), incremented by one for each frame
+ * - the value as fixed point number (value * 10^decimal places), a signed 16 bit number zigzag and varint encoded
+ *   (7 bits per byte, least significant bits first, MSB set if another byte follows)
+ * - the CRC-8 (polynomial 0x07, initial value 0) of the header, sequence number and value bytes.
+ *
+ * E.g. the value 12.3 for field 1 is sent as 0xA5 0x51 seq 0xF6 0x01 crc, i.e. 6 bytes instead of 8 for "f1:12.3;".
+ * The value of a frame with a correct CRC is formatted as text and passed to the field with the frame's field number.
+ * Frames with a wrong CRC or a too long value, i.e. more than 3 value bytes or a third value byte above 0x03, 
+ * are counted and dropped. The parser then searches the next sync byte, starting with the byte after the sync byte of the dropped frame,
+ * so a corrupted byte cannot take the following frame with it.
+ * Gaps in the sequence numbers are counted as lost frames. A frame whose sequence number is up to 128 before the expected one
+ * is a duplicate (or the sender restarted its numbering): it is displayed, but is neither counted as lost 
+ * nor changes the expected sequence number.
+ * If BINARY_FRAME_MAX_INVALID_BYTES bytes are received after the last valid frame which do not belong to a valid frame,
+ * the parser requests to switch back to ASCII messages, as for a frame with field number 0. So a sender which restarts 
+ * and sends ASCII messages, or a sender which never received the "bin:ok;" answer, is understood again after a few messages.
+ * ASCII messages contain no sync byte. A sender which sends no frames for a while stays in binary mode.
+ */
+class BinaryFrameParser {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param fieldsByNumber the fields by field number, field 1 at index 0. Entries may be NULL for unused numbers.
+     * @param fieldCount the number of entries in fieldsByNumber.
+     */
+    BinaryFrameParser(FieldConfiguration *const *fieldsByNumber, uint8_t fieldCount);
+
+    /**
+     * Parses the next received byte.
+     *
+     * @param received the received byte.
+     * @return what the byte completed, one of the MESSAGE_* constants.
+     */
+    uint8_t parse(uint8_t received);
+
+    /**
+     * Discards a partially received frame, forgets the last sequence number and the bytes received outside of valid frames.
+     */
+    void reset();
+
+    /**
+     * Returns how many frames were dropped because of a wrong CRC or a too long value.
+     */
+    uint16_t getCorruptedFrameCount();
+
+    /**
+     * Returns how many frames were lost, as seen from gaps in the sequence numbers.
+     */
+    uint16_t getLostFrameCount();
+
+    /**
+     * Sets the counters returned by getCorruptedFrameCount() and getLostFrameCount() to zero.
+     */
+    void resetCounters();
+
+  private:
+    // the states of the parser, i.e. which part of the frame is expected next
+    enum State : uint8_t
+    {
+      EXPECT_SYNC,
+      EXPECT_HEADER,
+      EXPECT_SEQUENCE_NUMBER,
+      EXPECT_VALUE,
+      EXPECT_CRC
+    };
+
+    // the fields by field number, field 1 at index 0
+    FieldConfiguration *const *fieldsByNumber;
+
+    // the number of entries in fieldsByNumber
+    uint8_t fieldCount;
+
+    // which part of the frame is expected next
+    State state;
+
+    // the header byte of the frame being received
+    uint8_t header;
+
+    // the sequence number of the frame being received
+    uint8_t sequenceNumber;
+
+    // the zigzag encoded value of the frame being received, as far as received
+    uint16_t encodedValue;
+
+    // how many value bytes of the frame being received were received
+    uint8_t valueByteCount;
+
+    // the CRC-8 of the frame being received, as far as received
+    uint8_t crc;
+
+    // the bytes of the frame being received after the sync byte, to search them for a sync byte if the frame is corrupted
+    uint8_t frameBytes[BINARY_FRAME_MAX_LENGTH - 1];
+
+    // how many bytes are in frameBytes
+    uint8_t frameByteCount;
+
+    // how many bytes were received after the last valid frame which do not belong to a valid frame
+    uint8_t invalidByteCount;
+
+    // whether a frame was received since the last reset, i.e. whether expectedSequenceNumber is known
+    boolean sequenceNumberKnown;
+
+    // the sequence number the next frame should have
+    uint8_t expectedSequenceNumber;
+
+    // how many frames were dropped because of a wrong CRC or a too long value
+    uint16_t corruptedFrameCount;
+
+    // how many frames were lost, as seen from gaps in the sequence numbers
+    uint16_t lostFrameCount;
+
+    uint8_t resync();
+    uint8_t dispatch();
+    uint8_t formatValue(int16_t value, uint8_t decimalPlaces, uint8_t integerDigits, char *text);
+};
+
+#endif
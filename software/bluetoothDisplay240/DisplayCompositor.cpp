@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+#include "DisplayCompositor.h"
+
+/**
+ * Constructor.
+ *
+ * @param display the display the fields are drawn on.
+ */
+DisplayCompositor::DisplayCompositor(DogDisplay *display)
+{
+  this->display = display;
+  fieldCount = 0;
+  renderedFields = 0;
+  lastRenderMillis = 0;
+}
+
+/**
+ * Adds a field to draw. Fields are asked for their columns in the order they were added,
+ * so fields sharing a page should be added from left to right.
+ *
+ * @param field the field to add. Must live as long as this object.
+ */
+void DisplayCompositor::addField(FieldConfiguration *field)
+{
+  if (fieldCount < DISPLAY_COMPOSITOR_MAX_FIELDS)
+  {
+    fields[fieldCount++] = field;
+  }
+}
+
+/**
+ * Draws the fields whose value was set since they were last drawn and whose refresh interval has passed.
+ * Does nothing if the last render was less than minFrameIntervalInMs ago.
+ *
+ * @param receiveBacklog how many received bytes were waiting to be parsed, used to detect load.
+ */
+void DisplayCompositor::render(uint8_t receiveBacklog)
+{
+  uint32_t now = millis();
+  if (renderedFields != 0 && now - lastRenderMillis < minFrameIntervalInMs)
+  {
+    return;
+  }
+
+  // one bit per field which is drawn by this render
+  uint8_t dueFields = 0;
+  boolean underLoad = receiveBacklog >= loadThreshold;
+  for (uint8_t i = 0; i < fieldCount; i++)
+  {
+    if (fields[i]->isDirty() && isDue(i, now, underLoad))
+    {
+      dueFields |= 0x01 << i;
+    }
+  }
+  if (dueFields == 0)
+  {
+    return;
+  }
+
+  // how long drawing each field took. The last byte of a field may still be shifted out during the calls for the next field,
+  // so the times are approximate
+  uint32_t fieldRenderMicros[DISPLAY_COMPOSITOR_MAX_FIELDS];
+
+  // only the latest value of each field is drawn, so the changes are worked out now and not for each set value
+  for (uint8_t i = 0; i < fieldCount; i++)
+  {
+    if (dueFields & (0x01 << i))
+    {
+      uint32_t startMicros = micros();
+      fields[i]->prepareRender();
+      fieldRenderMicros[i] = micros() - startMicros;
+    }
+  }
+
+  for (uint8_t yInBytes = 0; yInBytes < DISPLAY_HEIGHT_IN_BYTES; yInBytes++)
+  {
+    for (uint8_t i = 0; i < fieldCount; i++)
+    {
+      if (dueFields & (0x01 << i))
+      {
+        uint32_t startMicros = micros();
+        fields[i]->renderPage(yInBytes);
+        fieldRenderMicros[i] += micros() - startMicros;
+      }
+    }
+    // sends the rest of the page and releases the chip select, does nothing if no field has sent columns
+    display->endUpdate();
+  }
+
+  for (uint8_t i = 0; i < fieldCount; i++)
+  {
+    if (dueFields & (0x01 << i))
+    {
+      uint32_t startMicros = micros();
+      fields[i]->finishRender();
+      fields[i]->countRender(fieldRenderMicros[i] + micros() - startMicros);
+      lastFieldRenderMillis[i] = now;
+    }
+  }
+  renderedFields |= dueFields;
+  lastRenderMillis = now;
+}
+
+/**
+ * Returns whether a field has a value which is not yet drawn.
+ */
+boolean DisplayCompositor::isDirty()
+{
+  for (uint8_t i = 0; i < fieldCount; i++)
+  {
+    if (fields[i]->isDirty())
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Makes the next render draw all fields completely and send all their blocks to the display,
+ * to repair blocks whose change the display's shadow checksums missed. See DogDisplay.
+ */
+void DisplayCompositor::redraw()
+{
+  display->invalidateShadow();
+  for (uint8_t i = 0; i < fieldCount; i++)
+  {
+    fields[i]->redraw();
+  }
+}
+
+/**
+ * Returns whether the refresh interval of a field has passed since it was last drawn.
+ *
+ * @param fieldIndex the index of the field in the order the fields were added.
+ * @param now the current millis().
+ * @param underLoad whether the refresh interval is stretched by the field's priority.
+ */
+boolean DisplayCompositor::isDue(uint8_t fieldIndex, uint32_t now, boolean underLoad)
+{
+  if (!(renderedFields & (0x01 << fieldIndex)))
+  {
+    return true;
+  }
+  FieldConfiguration *field = fields[fieldIndex];
+  uint32_t refreshIntervalInMs = field->minRefreshIntervalInMs;
+  if (underLoad)
+  {
+    refreshIntervalInMs = max(refreshIntervalInMs, (uint32_t) minFrameIntervalInMs) << field->priority;
+  }
+  return now - lastFieldRenderMillis[fieldIndex] >= refreshIntervalInMs;
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+#ifndef DISPLAY_COMPOSITOR_H
+#define DISPLAY_COMPOSITOR_H
+
+#include <Arduino.h>
+
+#include "DogDisplay.h"
+#include "FieldConfiguration.h"
+
+#define DISPLAY_COMPOSITOR_MAX_FIELDS 4   // how many fields a compositor can draw
+#define DISPLAY_COMPOSITOR_MIN_FRAME_INTERVAL_IN_MS 50  // the default minimum time between two renders, i.e. at most 20 renders per second
+#define DISPLAY_COMPOSITOR_LOAD_THRESHOLD 16            // the default number of received but not yet parsed bytes from which on the display is under load
+
+/**
+ * Draws the changed values of several fields together, page by page.
+ *
+ * For each display page, all fields with a changed value send their changed columns
+ * in one update of the display, so the display is addressed once per page and chip select,
+ * and all fields change at the same time instead of one after the other.
+ *
+ * Renders are limited to one per minFrameIntervalInMs, and each field is drawn at most once per its minRefreshIntervalInMs.
+ * A field whose value is set in between stays dirty and is drawn with its latest value by a later render.
+ * When the receive backlog reaches loadThreshold, i.e. the fields cannot be drawn as fast as values arrive,
+ * the refresh interval of each field is stretched by 2^priority, so the most important fields keep being drawn on time.
+ */
+class DisplayCompositor {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param display the display the fields are drawn on.
+     */
+    DisplayCompositor(DogDisplay *display);
+
+    /**
+     * Adds a field to draw. Fields are asked for their columns in the order they were added,
+     * so fields sharing a page should be added from left to right.
+     *
+     * @param field the field to add. Must live as long as this object.
+     */
+    void addField(FieldConfiguration *field);
+
+    /**
+     * Draws the fields whose value was set since they were last drawn and whose refresh interval has passed.
+     * Does nothing if the last render was less than minFrameIntervalInMs ago.
+     *
+     * @param receiveBacklog how many received bytes were waiting to be parsed, used to detect load.
+     */
+    void render(uint8_t receiveBacklog = 0);
+
+    /**
+     * Returns whether a field has a value which is not yet drawn.
+     */
+    boolean isDirty();
+
+    /**
+     * Makes the next render draw all fields completely and send all their blocks to the display,
+     * to repair blocks whose change the display's shadow checksums missed. See DogDisplay.
+     */
+    void redraw();
+
+    // the minimum time between two renders
+    uint16_t minFrameIntervalInMs = DISPLAY_COMPOSITOR_MIN_FRAME_INTERVAL_IN_MS;
+
+    // the receive backlog from which on the fields are drawn at the refresh interval stretched by their priority
+    uint8_t loadThreshold = DISPLAY_COMPOSITOR_LOAD_THRESHOLD;
+
+  private:
+    // the display the fields are drawn on
+    DogDisplay *display;
+
+    // the fields to draw, in the order they were added
+    FieldConfiguration *fields[DISPLAY_COMPOSITOR_MAX_FIELDS];
+
+    // how many fields were added
+    uint8_t fieldCount;
+
+    // when each field was last drawn, in the order the fields were added
+    uint32_t lastFieldRenderMillis[DISPLAY_COMPOSITOR_MAX_FIELDS];
+
+    // one bit per field, in the order the fields were added, set if the field was drawn at least once
+    uint8_t renderedFields;
+
+    // when the last render took place
+    uint32_t lastRenderMillis;
+
+    boolean isDue(uint8_t fieldIndex, uint32_t now, boolean underLoad);
+};
+
+#endif
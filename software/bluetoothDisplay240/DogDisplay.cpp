@@ -12,13 +12,70 @@
 #include <Arduino.h>
 #include <SPI.h>
 #include <avr/pgmspace.h>
+#include <util/crc16.h>
 
 #include "DogDisplay.h"
 
+/**
+ * The bitmaps of the battery symbol for each filled height, three lines of BATTERY_SYMBOL_WIDTH bytes each.
+ * First line: 6 MSB: battery symbol head, 2 LSB: Data MSB. Second line: Data middle bytes. Third line: 6 MSB: Data LSB, 2 LSB: Battery bottom.
+ */
+const uint8_t batterySymbolBitmaps[BATTERY_SYMBOL_STATES][3 * BATTERY_SYMBOL_WIDTH] PROGMEM = {
+  {0xE0, 0x20, 0x39, 0x3C, 0x3C, 0x3C, 0x3C, 0x39, 0x20, 0xE0,  // filled height 0
+   0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF,
+   0xFF, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0xFF},
+  {0xE0, 0x20, 0x39, 0x3C, 0x3C, 0x3C, 0x3C, 0x39, 0x20, 0xE0,  // filled height 1
+   0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF,
+   0xFF, 0x80, 0xA0, 0xA0, 0xA0, 0xA0, 0xA0, 0xA0, 0x80, 0xFF},
+  {0xE0, 0x20, 0x39, 0x3C, 0x3C, 0x3C, 0x3C, 0x39, 0x20, 0xE0,  // filled height 2
+   0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF,
+   0xFF, 0x80, 0xB0, 0xB0, 0xB0, 0xB0, 0xB0, 0xB0, 0x80, 0xFF},
+  {0xE0, 0x20, 0x39, 0x3C, 0x3C, 0x3C, 0x3C, 0x39, 0x20, 0xE0,  // filled height 3
+   0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF,
+   0xFF, 0x80, 0xB8, 0xB8, 0xB8, 0xB8, 0xB8, 0xB8, 0x80, 0xFF},
+  {0xE0, 0x20, 0x39, 0x3C, 0x3C, 0x3C, 0x3C, 0x39, 0x20, 0xE0,  // filled height 4
+   0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF,
+   0xFF, 0x80, 0xBC, 0xBC, 0xBC, 0xBC, 0xBC, 0xBC, 0x80, 0xFF},
+  {0xE0, 0x20, 0x39, 0x3C, 0x3C, 0x3C, 0x3C, 0x39, 0x20, 0xE0,  // filled height 5
+   0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF,
+   0xFF, 0x80, 0xBE, 0xBE, 0xBE, 0xBE, 0xBE, 0xBE, 0x80, 0xFF},
+  {0xE0, 0x20, 0x39, 0x3C, 0x3C, 0x3C, 0x3C, 0x39, 0x20, 0xE0,  // filled height 6
+   0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF,
+   0xFF, 0x80, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0x80, 0xFF},
+  {0xE0, 0x20, 0x39, 0x3C, 0x3C, 0x3C, 0x3C, 0x39, 0x20, 0xE0,  // filled height 7
+   0xFF, 0x00, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00, 0xFF,
+   0xFF, 0x80, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0x80, 0xFF},
+  {0xE0, 0x20, 0x39, 0x3C, 0x3C, 0x3C, 0x3C, 0x39, 0x20, 0xE0,  // filled height 8
+   0xFF, 0x00, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0x00, 0xFF,
+   0xFF, 0x80, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0x80, 0xFF},
+  {0xE0, 0x20, 0x39, 0x3C, 0x3C, 0x3C, 0x3C, 0x39, 0x20, 0xE0,  // filled height 9
+   0xFF, 0x00, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0xE0, 0x00, 0xFF,
+   0xFF, 0x80, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0x80, 0xFF},
+  {0xE0, 0x20, 0x39, 0x3C, 0x3C, 0x3C, 0x3C, 0x39, 0x20, 0xE0,  // filled height 10
+   0xFF, 0x00, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0x00, 0xFF,
+   0xFF, 0x80, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0x80, 0xFF},
+  {0xE0, 0x20, 0x39, 0x3C, 0x3C, 0x3C, 0x3C, 0x39, 0x20, 0xE0,  // filled height 11
+   0xFF, 0x00, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0x00, 0xFF,
+   0xFF, 0x80, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0x80, 0xFF},
+  {0xE0, 0x20, 0x39, 0x3C, 0x3C, 0x3C, 0x3C, 0x39, 0x20, 0xE0,  // filled height 12
+   0xFF, 0x00, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0x00, 0xFF,
+   0xFF, 0x80, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0x80, 0xFF},
+  {0xE0, 0x20, 0x39, 0x3C, 0x3C, 0x3C, 0x3C, 0x39, 0x20, 0xE0,  // filled height 13
+   0xFF, 0x00, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0x00, 0xFF,
+   0xFF, 0x80, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0x80, 0xFF},
+  {0xE0, 0x20, 0x39, 0x3C, 0x3C, 0x3C, 0x3C, 0x39, 0x20, 0xE0,  // filled height 14
+   0xFF, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0xFF,
+   0xFF, 0x80, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0x80, 0xFF},
+  {0xE0, 0x20, 0xB9, 0xBC, 0xBC, 0xBC, 0xBC, 0xB9, 0x20, 0xE0,  // filled height 15
+   0xFF, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0xFF,
+   0xFF, 0x80, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0x80, 0xFF}};
+
 /**
  * Initializes the SPI Hardware/Software and the DOG Display.
  * 
  * Performs a reset to the Display and sets the pin numbers of the controller pins which are connected to the display.
+ * The port output registers and bit masks of the pins are looked up once here, 
+ * so that the pins can be switched later by direct register writes.
  * 
  * @param csPin the pin connected to the display CS0 (Chip Select) Pin.
  * @param siPin the pin connected to the display SDA/MOSI Pin.
@@ -29,7 +86,16 @@
 void DogDisplay::initialize(uint8_t csPin, uint8_t siPin, uint8_t clkPin, uint8_t cdPin, uint8_t resetPin) 
 {
 	DogDisplay::cdPin = cdPin;
+  cdPort = portOutputRegister(digitalPinToPort(cdPin));
+  cdBitMask = digitalPinToBitMask(cdPin);
 	pinMode(cdPin, OUTPUT);
+  cursorX = DISPLAY_WIDTH_IN_PX;
+  cursorYInBytes = DISPLAY_HEIGHT_IN_BYTES;
+  inDataMode = true;        // the CD pin level is unknown, so that commandMode() below sets it
+  chipSelected = false;
+  resetCounters();
+  updateBlockLength = 0;
+  batterySymbolFilledHeight = BATTERY_SYMBOL_STATES;
 	initializeSpi(csPin, siPin, clkPin);
 
 	// perform a Reset
@@ -64,6 +130,24 @@ void DogDisplay::clear()
 		
 		chipDeselect();
 	}
+
+  // the whole display is now known to be blank
+  uint16_t blankChecksum = 0xFFFF;
+  for (uint8_t i = 0; i < SHADOW_BLOCK_WIDTH_IN_PX; i++)
+  {
+    blankChecksum = _crc_ccitt_update(blankChecksum, 0x00);
+  }
+	for (uint8_t yInBytes = 0; yInBytes < DISPLAY_HEIGHT_IN_BYTES; yInBytes++)
+	{
+    for (uint8_t block = 0; block < SHADOW_BLOCKS_PER_PAGE; block++)
+    {
+      shadowChecksums[yInBytes][block] = blankChecksum;
+      setShadowValid(yInBytes, block, true);
+    }
+  }
+
+  // the battery symbol must be drawn again
+  batterySymbolFilledHeight = BATTERY_SYMBOL_STATES;
 }
 
 /**
@@ -71,6 +155,9 @@ void DogDisplay::clear()
  * 
  * The battery symbol is 3*8 pixel high and BATTERY_SYMBOL_WIDTH pixel wide, the highest 2 y pixel are left blank.
  * The symbol is not clipped to display size.
+ * The symbol is only sent to the display if its filled height changes, 
+ * and the filled height only changes if full leaves the range of the displayed height by more than BATTERY_SYMBOL_HYSTERESIS,
+ * so that noise in the battery measurement does not make the symbol flicker.
  * 
  * @param xInPixel (0 .. DISPLAY_WIDTH_IN_PX - BATTERY_SYMBOL_WIDTH - 1) : the start column of the battery symbol in pixel
  * @param yInBytes (0 .. DISPLAY_HEIGHT_IN_BYTES - 4) :  the start y of the battery symbol in units of bytes (8 pixel)
@@ -80,123 +167,378 @@ void DogDisplay::clear()
 void DogDisplay::drawBatterySymbol(uint16_t xInPixel, uint8_t yInBytes, uint8_t full)
 {
   uint8_t filledRectangleHeight = full / 16; // how high the filled rectangle inside the battery is (in px)
-
-  // First line: 6 MSB: battery symbol head, 2 LSB: Data MSB
-  position(xInPixel, yInBytes);
-  uint8_t line1[] = {0xE0,0x20,0x39,0x3C,0x3C,0x3C,0x3C,0x39,0x20,0xE0};
-  uint8_t pixelData;
-  if (filledRectangleHeight >= 14)
+  if (batterySymbolFilledHeight < BATTERY_SYMBOL_STATES)
   {
-    pixelData = fillBitsInByteStartingWithMsb(filledRectangleHeight - 14);
-    for (uint8_t i = 2; i < BATTERY_SYMBOL_WIDTH - 2; i++)
+    int16_t displayedFullMin = batterySymbolFilledHeight * 16 - BATTERY_SYMBOL_HYSTERESIS;
+    int16_t displayedFullMax = batterySymbolFilledHeight * 16 + 15 + BATTERY_SYMBOL_HYSTERESIS;
+    if (full >= displayedFullMin && full <= displayedFullMax)
     {
-      line1[i] |= pixelData;
+      return;
     }
   }
-  sendToSpiInDataMode(line1, BATTERY_SYMBOL_WIDTH);
+  batterySymbolFilledHeight = filledRectangleHeight;
 
-  // Second line: Data middle bytes
-  position(xInPixel, yInBytes + 1);
-  uint8_t line2[] = {0xFF,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF};
-  if (filledRectangleHeight >= 6)
+  const uint8_t *bitmap = batterySymbolBitmaps[filledRectangleHeight];
+  for (uint8_t line = 0; line < 3; line++)
   {
-    pixelData = fillBitsInByteStartingWithMsb(filledRectangleHeight - 6);
-    for (uint8_t i = 2; i < BATTERY_SYMBOL_WIDTH - 2; i++)
+    position(xInPixel, yInBytes + line);
+    dataMode();
+    chipSelect();
+    for (uint8_t i = 0; i < BATTERY_SYMBOL_WIDTH; i++)
     {
-      line2[i] = pixelData;
+      sendToSpi(pgm_read_byte(bitmap++));
     }
+    chipDeselect();
   }
-  sendToSpiInDataMode(line2, BATTERY_SYMBOL_WIDTH);
-
-  // Third line: 6 MSB: Data LSB, 2 LSB: Battery bottom
-  position(xInPixel, yInBytes + 2);
-  uint8_t line3[] = {0xFF,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0xFF};
-  pixelData = fillBitsInByteStartingWithMsb(filledRectangleHeight) >> 2;
-  for (uint8_t i = 2; i < BATTERY_SYMBOL_WIDTH - 2; i++)
-  {
-    line3[i] |= pixelData;
-  }
-  sendToSpiInDataMode(line3, BATTERY_SYMBOL_WIDTH);
 }
 
 /**
  * Sets the position of the write cursor in the display.
  * 
+ * Only the address bytes which differ from the known cursor position are sent,
+ * and nothing is sent if the cursor is already at the position.
+ * The chip stays selected afterwards, so data can follow without another chip select.
+ * 
  * @param xInPixel (0..MAX_X_IN_PIXEL - 1) : the x position of the write cursor.
  * @param yInBytes (0..MAX_Y_IN_BYTES - 1) : the y position of the write cursor.
  */
 void DogDisplay::position(uint16_t xInPixel, uint8_t yInBytes)  
 {
+  if (xInPixel == cursorX && yInBytes == cursorYInBytes)
+  {
+    return;
+  }
+  positionCount++;
   commandMode();
   chipSelect();
-	sendToSpi(0x10 + (xInPixel >> 4));   //MSB adress column
-	sendToSpi(0x00 + (xInPixel & 0x0F)); //LSB adress column
-  sendToSpi(0x70);                     //MSB adress page 
-	sendToSpi(0x60 + (yInBytes & 0x0F)); //LSB adress page	
-  chipDeselect();
+  // cursorX is DISPLAY_WIDTH_IN_PX if the column is unknown, cursorYInBytes is DISPLAY_HEIGHT_IN_BYTES if the page is unknown
+  if (cursorX >= DISPLAY_WIDTH_IN_PX || (xInPixel >> 4) != (cursorX >> 4))
+  {
+    sendToSpi(0x10 + (xInPixel >> 4));   //MSB adress column
+  }
+  if (cursorX >= DISPLAY_WIDTH_IN_PX || (xInPixel & 0x0F) != (cursorX & 0x0F))
+  {
+    sendToSpi(0x00 + (xInPixel & 0x0F)); //LSB adress column
+  }
+  if (cursorYInBytes >= DISPLAY_HEIGHT_IN_BYTES)
+  {
+    sendToSpi(0x70);                     //MSB adress page 
+  }
+  if (yInBytes != cursorYInBytes)
+  {
+    sendToSpi(0x60 + (yInBytes & 0x0F)); //LSB adress page	
+  }
+  cursorX = xInPixel;
+  cursorYInBytes = yInBytes;
 }
 
 /**
- * Selects the DOG Display chip by setting the CS Pin to low.
+ * Selects the DOG Display chip by setting the CS Pin to low, if it is not already selected.
  */
 void DogDisplay::chipSelect()
 {
-  digitalWrite(csPin, LOW);
+  if (chipSelected)
+  {
+    return;
+  }
+  chipSelected = true;
+  waitForSpiTransfer();
+  *csPort &= ~csBitMask;
 }
 
 /**
- * Deselects the DOG Display chip by setting the CS Pin to high.
+ * Deselects the DOG Display chip by setting the CS Pin to high, if it is selected.
  */
 void DogDisplay::chipDeselect()
 {
-  digitalWrite(csPin, HIGH);
+  if (!chipSelected)
+  {
+    return;
+  }
+  chipSelected = false;
+  waitForSpiTransfer();
+  *csPort |= csBitMask;
 }
 
 /**
- * Sets the DOG Display to command mode by setting the A0 Pin to low.
+ * Sets the DOG Display to command mode by setting the A0 Pin to low, if it is not already in command mode.
  */
 void DogDisplay::commandMode()
 {
-  digitalWrite(cdPin, LOW);
+  if (!inDataMode)
+  {
+    return;
+  }
+  waitForSpiTransfer();
+  *cdPort &= ~cdBitMask;
+  inDataMode = false;
 }
 
 /**
- * Sets the DOG Display to data mode by setting the A0 Pin to high.
+ * Sets the DOG Display to data mode by setting the A0 Pin to high, if it is not already in data mode.
  */
 void DogDisplay::dataMode()
 {
-  digitalWrite(cdPin, HIGH);
+  if (inDataMode)
+  {
+    return;
+  }
+  waitForSpiTransfer();
+  *cdPort |= cdBitMask;
+  inDataMode = true;
 }
 
 /**
  * Writes a byte to the SPI.
  * 
+ * In data mode, the shadow checksum of the written block becomes invalid.
+ * With hardware SPI, the method returns as soon as the byte is written to the SPI data register,
+ * the byte is shifted out while the next one is prepared.
+ * 
  * @param toSend the byte to send.
  */
 void DogDisplay::sendToSpi(uint8_t toSend) 
 {
+  spiByteCount++;
+  if (inDataMode && cursorX < DISPLAY_WIDTH_IN_PX)
+  {
+    setShadowValid(cursorYInBytes, cursorX / SHADOW_BLOCK_WIDTH_IN_PX, false);
+    cursorX++;
+    if (cursorX == DISPLAY_WIDTH_IN_PX)
+    {
+      // the controller may wrap to the next page at the end of the line
+      cursorYInBytes = DISPLAY_HEIGHT_IN_BYTES;
+    }
+  }
   if (useHardwareSpi) 
   {
-    SPI.transfer(toSend);
+    waitForSpiTransfer();
+    SPDR = toSend;
+    spiTransferPending = true;
   }
   else 
   {
-    uint8_t i = 8;
-    do 
+    // unrolled, the data bit is set while CLK is high and sampled on the rising edge
+    sendBitToSoftwareSpi(toSend & 0x80);
+    sendBitToSoftwareSpi(toSend & 0x40);
+    sendBitToSoftwareSpi(toSend & 0x20);
+    sendBitToSoftwareSpi(toSend & 0x10);
+    sendBitToSoftwareSpi(toSend & 0x08);
+    sendBitToSoftwareSpi(toSend & 0x04);
+    sendBitToSoftwareSpi(toSend & 0x02);
+    sendBitToSoftwareSpi(toSend & 0x01);
+  }
+}
+
+/**
+ * Clocks one bit out on the software SPI.
+ * 
+ * @param bit zero to send a 0 bit, any other value to send a 1 bit.
+ */
+inline void DogDisplay::sendBitToSoftwareSpi(uint8_t bit)
+{
+  if (bit) 
+  {
+    *siPort |= siBitMask;
+  }
+  else
+  {
+    *siPort &= ~siBitMask;
+  }
+  *clkPort &= ~clkBitMask;
+  *clkPort |= clkBitMask;
+}
+
+/**
+ * Waits until the hardware SPI has shifted out the last written byte.
+ * 
+ * At F_CPU/2, a byte takes 16 CPU cycles, which is about the time needed to prepare the next byte,
+ * so this rarely waits. Waiting for the transfer complete flag is cheaper than an interrupt per byte.
+ */
+void DogDisplay::waitForSpiTransfer()
+{
+  if (!spiTransferPending)
+  {
+    return;
+  }
+  while (!(SPSR & _BV(SPIF)))
+  {
+  }
+  spiTransferPending = false;
+}
+
+/**
+ * Waits until all bytes written to the SPI are transmitted.
+ */
+void DogDisplay::flush()
+{
+  waitForSpiTransfer();
+}
+
+/**
+ * Starts an update of a horizontal span of one page of the display.
+ * 
+ * The data bytes of the span are then passed one by one to update(), and the update is finished by endUpdate().
+ * Only the blocks of SHADOW_BLOCK_WIDTH_IN_PX columns whose content has changed are sent to the display.
+ * Between update() calls, no other method of the display must be called.
+ * startUpdate() may be called again before endUpdate() to continue with another span,
+ * so that several spans are sent without releasing the chip select in between.
+ * 
+ * @param xInPixel (0..DISPLAY_WIDTH_IN_PX - 1) : the x position of the first column of the span.
+ * @param yInBytes (0..DISPLAY_HEIGHT_IN_BYTES - 1) : the page of the span.
+ */
+void DogDisplay::startUpdate(uint16_t xInPixel, uint8_t yInBytes)
+{
+  if (updateBlockLength > 0)
+  {
+    flushUpdateBlock();
+  }
+  updateX = xInPixel;
+  updateYInBytes = yInBytes;
+  updateBlockLength = 0;
+}
+
+/**
+ * Passes the next data byte of the span started by startUpdate().
+ * 
+ * @param dataByte the byte for the next column, the LSB is the topmost pixel.
+ */
+void DogDisplay::update(uint8_t dataByte)
+{
+  updateBlock[updateBlockLength++] = dataByte;
+  if ((updateX + updateBlockLength) % SHADOW_BLOCK_WIDTH_IN_PX == 0)
+  {
+    flushUpdateBlock();
+  }
+}
+
+/**
+ * Finishes the update started by startUpdate().
+ */
+void DogDisplay::endUpdate()
+{
+  if (updateBlockLength > 0)
+  {
+    flushUpdateBlock();
+  }
+  chipDeselect();
+}
+
+/**
+ * Returns how many data bytes were not sent to the display since initialization or resetCounters()
+ * because update() found them unchanged.
+ */
+uint32_t DogDisplay::getSkippedByteCount()
+{
+  return skippedByteCount;
+}
+
+/**
+ * Returns how many bytes were sent to the display since initialization or resetCounters().
+ */
+uint32_t DogDisplay::getSpiByteCount()
+{
+  return spiByteCount;
+}
+
+/**
+ * Returns how many times position() sent position commands since initialization or resetCounters().
+ */
+uint32_t DogDisplay::getPositionCount()
+{
+  return positionCount;
+}
+
+/**
+ * Sets the counters returned by getSkippedByteCount(), getSpiByteCount() and getPositionCount() to zero.
+ */
+void DogDisplay::resetCounters()
+{
+  skippedByteCount = 0;
+  spiByteCount = 0;
+  positionCount = 0;
+}
+
+/**
+ * Checks the bytes collected by update() against the shadow and sends them if they have changed.
+ * 
+ * The bytes are all in one shadow block. If they fill the block completely, their checksum is compared to the shadow; 
+ * if the checksums are equal, nothing is sent. Otherwise the bytes are sent, 
+ * repositioning the display cursor if it is not at the first byte,
+ * and the checksum is stored in the shadow if the block was filled completely.
+ */
+void DogDisplay::flushUpdateBlock()
+{
+  uint8_t block = updateX / SHADOW_BLOCK_WIDTH_IN_PX;
+  boolean completeBlock = (updateX % SHADOW_BLOCK_WIDTH_IN_PX == 0 && updateBlockLength == SHADOW_BLOCK_WIDTH_IN_PX);
+  uint16_t checksum = 0xFFFF;
+  if (completeBlock)
+  {
+    for (uint8_t i = 0; i < updateBlockLength; i++)
+    {
+      checksum = _crc_ccitt_update(checksum, updateBlock[i]);
+    }
+    if (isShadowValid(updateYInBytes, block) && shadowChecksums[updateYInBytes][block] == checksum)
     {
-      if (toSend & 0x80) 
-      {
-        digitalWrite(siPin, HIGH);
-      }
-      else
-      {
-        digitalWrite(siPin, LOW);
-      }
-      digitalWrite(clkPin, LOW);
-      toSend <<= 1;
-      digitalWrite(clkPin, HIGH);
-    } while (--i);
+      skippedByteCount += updateBlockLength;
+      updateX += updateBlockLength;
+      updateBlockLength = 0;
+      return;
+    }
+  }
+
+  position(updateX, updateYInBytes);
+  dataMode();
+  chipSelect();
+  for (uint8_t i = 0; i < updateBlockLength; i++)
+  {
+    sendToSpi(updateBlock[i]);
+  }
+  if (completeBlock)
+  {
+    shadowChecksums[updateYInBytes][block] = checksum;
+    setShadowValid(updateYInBytes, block, true);
+  }
+  updateX += updateBlockLength;
+  updateBlockLength = 0;
+}
+
+/**
+ * Forgets the shadow checksums, so the next update of each block is sent even if it is unchanged.
+ */
+void DogDisplay::invalidateShadow()
+{
+  memset(shadowValid, 0x00, sizeof(shadowValid));
+}
+
+/**
+ * Sets whether the shadow checksum of a block is valid.
+ * 
+ * @param yInBytes the page of the block.
+ * @param block the number of the block in the page.
+ * @param valid whether the checksum is valid.
+ */
+void DogDisplay::setShadowValid(uint8_t yInBytes, uint8_t block, boolean valid)
+{
+  if (valid)
+  {
+    shadowValid[yInBytes][block / 8] |= 0x01 << (block % 8);
   }
+  else
+  {
+    shadowValid[yInBytes][block / 8] &= ~(0x01 << (block % 8));
+  }
+}
+
+/**
+ * Returns whether the shadow checksum of a block is valid.
+ * 
+ * @param yInBytes the page of the block.
+ * @param block the number of the block in the page.
+ */
+boolean DogDisplay::isShadowValid(uint8_t yInBytes, uint8_t block)
+{
+  return shadowValid[yInBytes][block / 8] & (0x01 << (block % 8));
 }
 
 /**
@@ -222,7 +564,14 @@ void DogDisplay::initializeSpi(uint8_t csPin, uint8_t siPin, uint8_t clkPin)
 {
 	DogDisplay::csPin = csPin;
   DogDisplay::siPin = siPin;
+  spiTransferPending = false;
   DogDisplay::clkPin = clkPin;
+  csPort = portOutputRegister(digitalPinToPort(csPin));
+  csBitMask = digitalPinToBitMask(csPin);
+  siPort = portOutputRegister(digitalPinToPort(siPin));
+  siBitMask = digitalPinToBitMask(siPin);
+  clkPort = portOutputRegister(digitalPinToPort(clkPin));
+  clkBitMask = digitalPinToBitMask(clkPin);
 	
 	if (siPin == MOSI && clkPin == SCK)
 	{
@@ -233,7 +582,7 @@ void DogDisplay::initializeSpi(uint8_t csPin, uint8_t siPin, uint8_t clkPin)
 		useHardwareSpi = false;
 	}
 	
-	chipDeselect();
+	*csPort |= csBitMask;
 	pinMode(csPin, OUTPUT);
 	pinMode(siPin, OUTPUT);
 	
@@ -245,7 +594,7 @@ void DogDisplay::initializeSpi(uint8_t csPin, uint8_t siPin, uint8_t clkPin)
 		SPI.begin();
 		SPI.setBitOrder(MSBFIRST);
 		SPI.setDataMode(SPI_MODE3);
-		SPI.setClockDivider(SPI_CLOCK_DIV4);
+		SPI.setClockDivider(SPI_CLOCK_DIV2); // the fastest AVR SPI clock (F_CPU/2) is still well below the maximum serial clock of the display
 	}
 }
 
@@ -264,23 +613,3 @@ void DogDisplay::sendToSpiWithChipSelect(uint8_t *toSend, uint16_t dataLength)
 	}	while(--dataLength);
 	chipDeselect();
 }
-
-/**
- * Fills bits (i.e sets them to one) in a byte starting with the most significant bit (MSB) (0x80).
- * 
- * The bits not filled are zeroed.
- * 
- * @param bitsToFill (0..255) : how many bits should be set to 1. If the value is >=7, all bits are set to one.
- */
-uint8_t DogDisplay::fillBitsInByteStartingWithMsb(uint8_t bitsToFill)
-{
-  uint8_t result = 0x00;
-  for (uint8_t i = 0; i < 8; i++)
-  {
-    if (bitsToFill > i)
-    {
-      result |= 0x80 >> i;
-    }
-  }
-  return result;
-}
@@ -12,12 +12,28 @@
 #ifndef DOG_DISPLAY_H
 #define DOG_DISPLAY_H
 
+#include <Arduino.h>
+
+#ifndef PORT_REGISTER_TYPE
+#define PORT_REGISTER_TYPE volatile uint8_t // the type of the port output registers, as returned by portOutputRegister()
+#endif
+
 #define DISPLAY_WIDTH_IN_PX 240   // The width of the display in pixel 
 #define DISPLAY_HEIGHT_IN_BYTES 8 // The height of the display in Bytes (i.e. 8 px)
 
 #define BATTERY_SYMBOL_WIDTH 10   // The width of the display in pixel 
+#define BATTERY_SYMBOL_STATES 16  // The number of different filled heights of the battery symbol
+#define BATTERY_SYMBOL_HYSTERESIS 4 // By how much the battery fill value must leave the range of the displayed filled height to change it
 #define INITLEN 14
 
+#define SHADOW_BLOCK_WIDTH_IN_PX 16 // The width in pixel of the column blocks for which the shadow stores a checksum
+#define SHADOW_BLOCKS_PER_PAGE (DISPLAY_WIDTH_IN_PX / SHADOW_BLOCK_WIDTH_IN_PX)
+
+// Drives the EA DOGM240 display via SPI.
+// Updates are compared to a compact shadow of the display content, which stores only a 16 bit checksum per block of columns,
+// and unchanged blocks are not sent. A changed block whose checksum equals the stored one (a probability of 1/65536 per changed block)
+// is skipped although it differs, and stays wrong on the display. invalidateShadow() makes the next update of every block be sent,
+// so a caller which draws everything again after it, e.g. DisplayCompositor::redraw(), repairs such blocks.
 class DogDisplay
 {
   public:
@@ -25,6 +41,8 @@ class DogDisplay
    * Initializes the SPI Hardware/Software and the DOG Display.
    * 
    * Performs a reset to the Display and sets the pin numbers of the controller pins which are connected to the display.
+   * The port output registers and bit masks of the pins are looked up once here, 
+   * so that the pins can be switched later by direct register writes.
    * 
    * @param csPin the pin connected to the display CS0 (Chip Select) Pin.
    * @param siPin the pin connected to the display SDA/MOSI Pin.
@@ -44,6 +62,7 @@ class DogDisplay
    * 
    * The battery symbol is 3*8 pixel high and BATTERY_SYMBOL_WIDTH pixel wide, the highest 2 y pixel are left blank.
    * The symbol is not clipped to display size, so do not use too high x and y values.
+   * The symbol is only sent to the display if its filled height changes, with a hysteresis of BATTERY_SYMBOL_HYSTERESIS.
    * 
    * @param xInPixel (0 .. DISPLAY_WIDTH_IN_PX - BATTERY_SYMBOL_WIDTH - 1) : the start column of the battery symbol in pixel
    * @param yInBytes (0 .. DISPLAY_HEIGHT_IN_BYTES - 4) :  the start y of the battery symbol in units of bytes (8 pixel)
@@ -55,23 +74,27 @@ class DogDisplay
   /**
    * Sets the position of the write cursor in the display.
    * 
+   * Only the address bytes which differ from the known cursor position are sent,
+   * and nothing is sent if the cursor is already at the position.
+   * The chip stays selected afterwards, so data can follow without another chip select.
+   * 
    * @param xInPixel (0..MAX_X_IN_PIXEL - 1) : the x position of the write cursor.
    * @param yInBytes (0..MAX_Y_IN_BYTES - 1) : the y position of the write cursor.
    */
   void position(uint16_t xInPixel, uint8_t yInBytes);
 
   /**
-   * Selects the DOG Display chip by setting the CS Pin to low.
+   * Selects the DOG Display chip by setting the CS Pin to low, if it is not already selected.
    */
   void chipSelect();
   
   /**
-   * Deselects the DOG Display chip by setting the CS Pin to high.
+   * Deselects the DOG Display chip by setting the CS Pin to high, if it is selected.
    */
   void chipDeselect();
 
   /**
-   * Sets the DOG Display to data mode by setting the A0 Pin to high.
+   * Sets the DOG Display to data mode by setting the A0 Pin to high, if it is not already in data mode.
    */
   void dataMode();
 
@@ -79,25 +102,120 @@ class DogDisplay
    * Writes a byte to the SPI.
    * 
    * This is a plain SPI write, it does not perform a chip select and does not send command or data mode.
+   * With hardware SPI, the method returns as soon as the byte is written to the SPI data register,
+   * the byte is shifted out while the next one is prepared.
    * 
    * @param toSend the byte to send.
    */
   void sendToSpi(uint8_t toSend);
 
+  /**
+   * Waits until all bytes written to the SPI are transmitted.
+   */
+  void flush();
+
+  /**
+   * Starts an update of a horizontal span of one page of the display.
+   * 
+   * The data bytes of the span are then passed one by one to update(), and the update is finished by endUpdate().
+   * Only the blocks of SHADOW_BLOCK_WIDTH_IN_PX columns whose content has changed are sent to the display.
+   * Between update() calls, no other method of the display must be called.
+   * startUpdate() may be called again before endUpdate() to continue with another span,
+   * so that several spans are sent without releasing the chip select in between.
+   * 
+   * @param xInPixel (0..DISPLAY_WIDTH_IN_PX - 1) : the x position of the first column of the span.
+   * @param yInBytes (0..DISPLAY_HEIGHT_IN_BYTES - 1) : the page of the span.
+   */
+  void startUpdate(uint16_t xInPixel, uint8_t yInBytes);
+
+  /**
+   * Passes the next data byte of the span started by startUpdate().
+   * 
+   * @param dataByte the byte for the next column, the LSB is the topmost pixel.
+   */
+  void update(uint8_t dataByte);
+
+  /**
+   * Finishes the update started by startUpdate().
+   */
+  void endUpdate();
+
+  /**
+   * Forgets the shadow checksums, so the next update of each block is sent even if it is unchanged.
+   */
+  void invalidateShadow();
+
+  /**
+   * Returns how many data bytes were not sent to the display since initialization or resetCounters()
+   * because update() found them unchanged.
+   */
+  uint32_t getSkippedByteCount();
+
+  /**
+   * Returns how many bytes were sent to the display since initialization or resetCounters().
+   */
+  uint32_t getSpiByteCount();
+
+  /**
+   * Returns how many times position() sent position commands since initialization or resetCounters().
+   */
+  uint32_t getPositionCount();
+
+  /**
+   * Sets the counters returned by getSkippedByteCount(), getSpiByteCount() and getPositionCount() to zero.
+   */
+  void resetCounters();
+
   private:
   uint8_t csPin;            // the pin connected to the display CS0 (Chip Select) Pin.
 	uint8_t siPin;            // the pin connected to the display SDA/MOSI Pin.
 	uint8_t clkPin;           // the pin connected to the display CSK/CLK Pin.
   uint8_t cdPin;            // the pin connected to the display CD Pin.
 	boolean useHardwareSpi;   // true: use hardware SPI, false: use software SPI
+  boolean spiTransferPending; // whether the hardware SPI may still be shifting out the last written byte
+  // The display pins are switched by direct writes to their port output registers instead of digitalWrite().
+  // The writes are read-modify-write, so no interrupt handler must write to pins of the same ports.
+  PORT_REGISTER_TYPE *csPort;  // the output register of the port of the CS pin
+  uint8_t csBitMask;            // the bit of the CS pin in its port output register
+  PORT_REGISTER_TYPE *cdPort;  // the output register of the port of the CD pin
+  uint8_t cdBitMask;            // the bit of the CD pin in its port output register
+  PORT_REGISTER_TYPE *siPort;  // the output register of the port of the SI pin
+  uint8_t siBitMask;            // the bit of the SI pin in its port output register
+  PORT_REGISTER_TYPE *clkPort; // the output register of the port of the CLK pin
+  uint8_t clkBitMask;           // the bit of the CLK pin in its port output register
+  uint16_t cursorX;         // the column the display writes the next data byte to, as far as known
+  uint8_t cursorYInBytes;   // the page the display writes the next data byte to, as far as known
+  boolean inDataMode;       // whether the CD pin is currently set to data mode
+  boolean chipSelected;     // whether the CS pin is currently set to low
+  uint8_t batterySymbolFilledHeight; // the filled height of the displayed battery symbol, BATTERY_SYMBOL_STATES if none is displayed
+
+  // Compact shadow of the display content: a CRC-CCITT checksum for each block of SHADOW_BLOCK_WIDTH_IN_PX columns of each page,
+  // and a bit per block telling whether the checksum is valid, i.e. whether the block was last written completely by update().
+  // CRC-CCITT detects every change of up to 3 bits in a block, so only larger changes can be missed, with a probability of 1/65536.
+  // A missed change stays on the display until the block is sent again after invalidateShadow().
+  // With blocks of 16 columns, this takes 8 * 15 * 2 bytes of checksums plus 8 * 2 bytes of valid bits.
+  uint16_t shadowChecksums[DISPLAY_HEIGHT_IN_BYTES][SHADOW_BLOCKS_PER_PAGE];
+  uint8_t shadowValid[DISPLAY_HEIGHT_IN_BYTES][(SHADOW_BLOCKS_PER_PAGE + 7) / 8];
+
+  uint16_t updateX;                                // the column of the first byte in updateBlock
+  uint8_t updateYInBytes;                          // the page of the running update
+  uint8_t updateBlockLength;                       // how many bytes are in updateBlock
+  uint8_t updateBlock[SHADOW_BLOCK_WIDTH_IN_PX];   // the bytes passed to update() which are not yet checked and sent
+  uint32_t skippedByteCount;                       // how many bytes were not sent because they were unchanged
+  uint32_t spiByteCount;                           // how many bytes were sent to the display
+  uint32_t positionCount;                          // how many times position() sent position commands
+
   uint8_t init_sequence[INITLEN] = {0xF1, 0x3F, 0xF2, 0x00, 0xF3, 0x3F, 0x81, 0xB7, 0xC0, 0x02, 0xA3, 0xE9, 0xA9, 0xD1}; // the byte sequence used to initialize the display
 
 	void initializeSpi(uint8_t csPin, uint8_t siPin, uint8_t clkPin);
 	void sendToSpiWithChipSelect(uint8_t *toSend, uint16_t dataLength);
   void sendToSpiInDataMode(uint8_t *dataBytes, uint16_t dataLength);
   void commandMode();
-
-  uint8_t fillBitsInByteStartingWithMsb(uint8_t bitsToFill);
+  void sendBitToSoftwareSpi(uint8_t bit);
+  void waitForSpiTransfer();
+  void flushUpdateBlock();
+  void setShadowValid(uint8_t yInBytes, uint8_t block, boolean valid);
+  boolean isShadowValid(uint8_t yInBytes, uint8_t block);
 };
 
 #endif
@@ -13,37 +13,379 @@
 #include "StringDisplay.h"
 
 /**
- * Displays a string in the field.
+ * Returns whether the field must be drawn: the value set by setValue() is not yet displayed, or redraw() was called.
+ */
+boolean FieldConfiguration::isDirty()
+{
+  return dirty || redrawPending;
+}
+
+/**
+ * Makes the next render draw the whole field instead of the changed columns only, e.g. to repair the display content.
+ * The render is not counted as a new value in the latency histogram.
+ */
+void FieldConfiguration::redraw()
+{
+  previousValueDisplayed = false;
+  redrawPending = true;
+}
+
+/**
+ * Returns how many values set by setValue() were replaced by a newer value before they were displayed.
+ */
+uint16_t FieldConfiguration::getDroppedValueCount()
+{
+  return droppedValueCount;
+}
+
+/**
+ * Returns how many times the field was drawn.
+ */
+uint16_t FieldConfiguration::getRenderCount()
+{
+  return renderCount;
+}
+
+/**
+ * Returns how long drawing the field took in total, in microseconds.
+ */
+uint32_t FieldConfiguration::getRenderMicros()
+{
+  return renderMicros;
+}
+
+/**
+ * Returns how long drawing the field took at most, in microseconds.
+ */
+uint32_t FieldConfiguration::getMaxRenderMicros()
+{
+  return maxRenderMicros;
+}
+
+/**
+ * Counts a render of the field. Called by DisplayCompositor after drawing the field.
+ * If a value set by setValue() was drawn, the time since it was received is counted in the latency histogram.
+ * The field is no longer dirty afterwards.
+ *
+ * @param renderMicros how long drawing the field took, in microseconds.
+ */
+void FieldConfiguration::countRender(uint32_t renderMicros)
+{
+  renderCount++;
+  this->renderMicros += renderMicros;
+  maxRenderMicros = max(maxRenderMicros, renderMicros);
+  if (dirty)
+  {
+    latencyHistogram.add(micros() - valueMicros);
+  }
+  dirty = false;
+  redrawPending = false;
+}
+
+/**
+ * Returns the histogram of the times from receiving values to the end of drawing them, see setValueMicros().
+ */
+LatencyHistogram *FieldConfiguration::getLatencyHistogram()
+{
+  return &latencyHistogram;
+}
+
+/**
+ * Sets the dropped value and render counters to zero and empties the latency histogram.
+ */
+void FieldConfiguration::resetCounters()
+{
+  droppedValueCount = 0;
+  renderCount = 0;
+  renderMicros = 0;
+  maxRenderMicros = 0;
+  latencyHistogram.reset();
+}
+
+/**
+ * Called by DisplayCompositor::render() before the first page is rendered.
+ * Fields which need to compare the set value with the displayed one do it here instead of in setValue(),
+ * so values which are replaced before they are displayed cost nothing but the copy.
+ */
+void FieldConfiguration::prepareRender()
+{
+}
+
+/**
+ * Sets when the value set by the last call of setValue() was received. Called by MessageParser
+ * with the micros() when it parses the ';' which ends the message, so that values followed by further values
+ * of the same message count from the end of the message as well. Other values count from the call of setValue().
+ *
+ * @param valueMicros the micros() when the ';' ending the message containing the value was parsed.
+ */
+void FieldConfiguration::setValueMicros(uint32_t valueMicros)
+{
+  this->valueMicros = valueMicros;
+}
+
+/**
+ * Marks the field as to be drawn by the next call to DisplayCompositor::render() and remembers when the value was set.
+ * If the previously set value is not yet displayed, it is counted as dropped.
+ */
+void FieldConfiguration::markDirty()
+{
+  if (dirty)
+  {
+    droppedValueCount++;
+  }
+  dirty = true;
+  valueMicros = micros();
+}
+
+/**
+ * Sets the characters to display in the field. Nothing is drawn here: the characters are only copied as pending value
+ * and the field is marked dirty, so the next call to DisplayCompositor::render() draws it.
+ * If the pending value set before was not yet drawn, it is replaced and counted as dropped value.
+ * 
+ * The columns which differ from the displayed string are found by prepareRender(), only they are redrawn.
+ * 
+ * @param value the characters to display, need not be zero terminated
+ * @param length the number of characters to display
+ */
+void StringFieldConfiguration::setValue(const char *value, uint8_t length)
+{
+  valueLength = min(length, StringDisplay::MAX_DISPLAYABLE_STRING_LENGTH);
+  memcpy(this->value, value, valueLength);
+  markDirty();
+}
+
+/**
+ * Lays out the value for all pages of the render and finds the columns of the value area which differ from the displayed value, 
+ * before the first page is rendered.
+ * 
+ * With tabular digits, a value which only differs from the displayed value in its digits has the same layout,
+ * so only the glyphs of the changed digits are replaced in the layout of the displayed value and their slots are marked,
+ * without laying out the value again.
+ */
+void StringFieldConfiguration::prepareRender()
+{
+  int16_t valueWidthInPx = getValueWidthInPx();
+  if (tabularDigits && previousValueDisplayed && hasPreviousLayout())
+  {
+    updateChangedSlots(valueWidthInPx);
+    return;
+  }
+  layout.setString(valueFont, value, valueLength, tabularDigits);
+  markChangedColumns(layout, valueWidthInPx - layout.getWidth(), valueWidthInPx);
+}
+
+/**
+ * Sends the changed columns of the value on a display page.
  * 
  * The upper left corner of the displaywindow for the string is defined by (xOffsetInPx, yOffsetInBytes). 
  * The display window is widthInPx pixel long and heightInBytes bytes high.
  * 
- * @param toDisplay the string to display
+ * @param yInBytes the display page to send.
  */
-void StringFieldConfiguration::displayValue(String toDisplay)
+void StringFieldConfiguration::renderPage(uint8_t yInBytes)
 {
-  StringDisplay stringDisplay(gfxValueFont, toDisplay);
-  word xOffsetInField = widthInPx - stringDisplay.getWidth() - labelBitmapWithInPx - labelValueXDistanceInPx;
-  for (uint16_t yByteCount = yOffsetInBytes; yByteCount < yOffsetInBytes + heightInBytes; yByteCount++) 
+  if (yInBytes < yOffsetInBytes || yInBytes >= yOffsetInBytes + heightInBytes)
+  {
+    return;
+  }
+  yInBytes -= yOffsetInBytes;
+  int16_t valueWidthInPx = getValueWidthInPx();
+  int16_t xOffsetInField = valueWidthInPx - layout.getWidth();
+  int16_t x = 0;
+  while (x < valueWidthInPx)
   {
-    display.position(xOffsetInPx, yByteCount);
-    display.dataMode();
-    display.chipSelect();
-    for (word x = 0; x < widthInPx - labelBitmapWithInPx - labelValueXDistanceInPx; x++) 
+    // find the next span of changed columns
+    while (x < valueWidthInPx && !(changedColumns[x / 8] & (0x01 << (x % 8))))
+    {
+      x++;
+    }
+    int16_t spanStart = x;
+    while (x < valueWidthInPx && (changedColumns[x / 8] & (0x01 << (x % 8))))
+    {
+      x++;
+    }
+    if (spanStart == x)
+    {
+      break;
+    }
+
+    display->startUpdate(xOffsetInPx + spanStart, yOffsetInBytes + yInBytes);
+    if (x > xOffsetInField && spanStart < xOffsetInField + (int16_t) layout.getWidth())
+    {
+      layout.startPage(yInBytes, max(spanStart, xOffsetInField) - xOffsetInField);
+    }
+    for (int16_t xInSpan = spanStart; xInSpan < x; xInSpan++) 
     {
       uint8_t toSend = 0;
-      for (uint16_t yBit = 0; yBit < 8; yBit++)
+      if (xInSpan >= xOffsetInField && xInSpan < xOffsetInField + (int16_t) layout.getWidth())
+      {
+        toSend = layout.nextColumn();
+      }
+      display->update(toSend);
+    }
+  }
+}
+
+/**
+ * Remembers the value set by setValue() as displayed, after all pages are rendered.
+ */
+void StringFieldConfiguration::finishRender()
+{
+  rememberValue(layout, getValueWidthInPx() - layout.getWidth());
+}
+
+/**
+ * Returns the width of the value area of the field, i.e. the field without the label.
+ */
+int16_t StringFieldConfiguration::getValueWidthInPx()
+{
+  return widthInPx - labelBitmapWithInPx - labelValueXDistanceInPx;
+}
+
+/**
+ * Returns the width of the space reserved for the character c in the value, i.e. the slot width for digits if tabularDigits is set.
+ */
+uint8_t StringFieldConfiguration::getCharacterXAdvance(char c)
+{
+  if (tabularDigits && StringDisplay::isTabularDigit(c))
+  {
+    return valueFont->getMaxDigitXAdvance();
+  }
+  return valueFont->getXAdvance(c);
+}
+
+/**
+ * Returns whether the value set by setValue() is laid out like the displayed value,
+ * i.e. has the same length and differs from it only in digits. Only meaningful if tabularDigits is set.
+ */
+boolean StringFieldConfiguration::hasPreviousLayout()
+{
+  if (valueLength != previousValueLength)
+  {
+    return false;
+  }
+  for (uint8_t i = 0; i < valueLength; i++)
+  {
+    if (value[i] != previousValue[i] && !(StringDisplay::isTabularDigit(value[i]) && StringDisplay::isTabularDigit(previousValue[i])))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Replaces the characters which differ from the displayed value in the layout of the displayed value
+ * and marks their slots as to be redrawn.
+ * Must only be called if hasPreviousLayout() returns true, then every character stays in the slot of the displayed character.
+ * 
+ * @param valueWidthInPx the width of the value area of the field
+ */
+void StringFieldConfiguration::updateChangedSlots(int16_t valueWidthInPx)
+{
+  memset(changedColumns, 0x00, (valueWidthInPx + 7) / 8);
+  for (uint8_t i = 0; i < valueLength; i++)
+  {
+    if (value[i] == previousValue[i])
+    {
+      continue;
+    }
+    int16_t startX = previousXOffsetInField + layout.getStartX(i);
+    int16_t endX = startX + layout.getGlyph(i).xAdvance;
+    for (int16_t x = max(startX, 0); x < min(endX, valueWidthInPx); x++)
+    {
+      changedColumns[x / 8] |= 0x01 << (x % 8);
+    }
+    layout.setCharacter(i, value[i]);
+  }
+}
+
+/**
+ * Marks the columns of the value area which need to be redrawn, compared to the previously displayed value.
+ * 
+ * The space of a character is unchanged if the previous value had the same character at the same position.
+ * All other character spaces of the new and the previous value are marked as changed.
+ * If the previously displayed value is not known, all columns are marked.
+ * 
+ * @param stringDisplay the new value to display
+ * @param xOffsetInField the x position in the field where the new value starts
+ * @param valueWidthInPx the width of the value area of the field
+ */
+void StringFieldConfiguration::markChangedColumns(StringDisplay &stringDisplay, int16_t xOffsetInField, int16_t valueWidthInPx)
+{
+  uint8_t changedColumnsLength = (valueWidthInPx + 7) / 8;
+  if (!previousValueDisplayed)
+  {
+    memset(changedColumns, 0xFF, changedColumnsLength);
+    return;
+  }
+  memset(changedColumns, 0x00, changedColumnsLength);
+
+  // previous characters which are not at the same position in the new value
+  int16_t previousStartX = previousXOffsetInField;
+  for (uint8_t i = 0; i < previousValueLength; i++)
+  {
+    int16_t previousEndX = previousStartX + getCharacterXAdvance(previousValue[i]);
+    boolean unchanged = false;
+    for (uint8_t j = 0; j < stringDisplay.getLength(); j++)
+    {
+      if (xOffsetInField + stringDisplay.getStartX(j) == previousStartX && stringDisplay.getCharacter(j) == previousValue[i])
       {
-        uint16_t y = yByteCount * 8 + yBit;
-        if (stringDisplay.getBitAt(x - xOffsetInField, y))
-        {
-          toSend |= 0x01 << yBit;
-        }
+        unchanged = true;
+        break;
       }
-      display.sendToSpi(toSend);
     }
-    display.chipDeselect();
+    if (!unchanged)
+    {
+      for (int16_t x = max(previousStartX, 0); x < min(previousEndX, valueWidthInPx); x++)
+      {
+        changedColumns[x / 8] |= 0x01 << (x % 8);
+      }
+    }
+    previousStartX = previousEndX;
   }
+
+  // new characters which were not at the same position in the previous value
+  for (uint8_t j = 0; j < stringDisplay.getLength(); j++)
+  {
+    int16_t startX = xOffsetInField + stringDisplay.getStartX(j);
+    int16_t endX = startX + stringDisplay.getGlyph(j).xAdvance;
+    boolean unchanged = false;
+    previousStartX = previousXOffsetInField;
+    for (uint8_t i = 0; i < previousValueLength; i++)
+    {
+      if (previousStartX == startX && previousValue[i] == stringDisplay.getCharacter(j))
+      {
+        unchanged = true;
+        break;
+      }
+      previousStartX += getCharacterXAdvance(previousValue[i]);
+    }
+    if (!unchanged)
+    {
+      for (int16_t x = max(startX, 0); x < min(endX, valueWidthInPx); x++)
+      {
+        changedColumns[x / 8] |= 0x01 << (x % 8);
+      }
+    }
+  }
+}
+
+/**
+ * Remembers the displayed value, so that the next call to setValue() can mark only the changed characters.
+ * 
+ * @param stringDisplay the displayed value
+ * @param xOffsetInField the x position in the field where the displayed value starts
+ */
+void StringFieldConfiguration::rememberValue(StringDisplay &stringDisplay, int16_t xOffsetInField)
+{
+  previousValueLength = stringDisplay.getLength();
+  for (uint8_t i = 0; i < previousValueLength; i++)
+  {
+    previousValue[i] = stringDisplay.getCharacter(i);
+  }
+  previousXOffsetInField = xOffsetInField;
+  previousValueDisplayed = true;
 }
 
 /**
@@ -56,68 +398,149 @@ void StringFieldConfiguration::displayUnit()
 {
   for (uint8_t yByteCount = 0; yByteCount < labelBitmapHeightInBytes; yByteCount++) 
   {
-    display.position(xOffsetInPx + widthInPx - labelBitmapWithInPx, yOffsetInBytes + yByteCount);
-    display.dataMode();
-    display.chipSelect();
+    display->position(xOffsetInPx + widthInPx - labelBitmapWithInPx, yOffsetInBytes + yByteCount);
+    display->dataMode();
+    display->chipSelect();
     for (uint8_t x = 0; x < labelBitmapWithInPx; x++) 
     {      
       uint8_t toSend = pgm_read_byte(labelBitmap + yByteCount * labelBitmapWithInPx + x);
-      display.sendToSpi(toSend);
+      display->sendToSpi(toSend);
     }
-    display.chipDeselect();
+    display->chipDeselect();
   }
 }
 
 /**
- * Parses the passed String as int and displays the parsed value on the bar graph. 
+ * Parses the passed characters as int and sets the parsed value to display on the bar graph.
+ * Nothing is drawn here: the field is marked dirty, so the next call to DisplayCompositor::render() draws it.
+ * If the value set before was not yet drawn, it is replaced and counted as dropped value.
+ * 
+ * Only the columns between the previous and the new ends of the bar are redrawn,
+ * and the zero extension only if it changes.
  * 
- * @param value the value to display. Must be parseable as int. 
+ * @param value the value to display: an optional minus sign followed by digits, parsing stops at the first other character.
  *        The displayable range is -(widthInPx - 1) / 2 ... (widthInPx - 1) / 2.
  *        Smaller or larger values are clipped.
+ * @param length the number of characters of value
  */
-void BarFieldConfiguration::displayValue(String value)
+void BarFieldConfiguration::setValue(const char *value, uint8_t length)
 {
-  int16_t intValue = value.toInt();
+  boolean negative = length > 0 && value[0] == '-';
+  int16_t intValue = 0;
+  for (uint8_t i = negative ? 1 : 0; i < length && value[i] >= '0' && value[i] <= '9' && intValue < 1000; i++)
+  {
+    intValue = intValue * 10 + (value[i] - '0');
+  }
+  if (negative)
+  {
+    intValue = -intValue;
+  }
   uint16_t middleX = getMiddleX();
-  int16_t startX;
-  int16_t endX;
   if (intValue < 0)
   {
-    startX = middleX + intValue;
-    if (startX < 0)
+    valueStartX = middleX + intValue;
+    if (valueStartX < 0)
     {
-      startX = 0;
+      valueStartX = 0;
     }
-    endX = middleX; 
+    valueEndX = middleX; 
   }
   else 
   {
-    startX = middleX;
-    endX = middleX + intValue;
-    if (endX >= widthInPx)
+    valueStartX = middleX;
+    valueEndX = middleX + intValue;
+    if (valueEndX >= widthInPx)
     {
-      endX = widthInPx - 1;
+      valueEndX = widthInPx - 1;
     }
   }
-  for (uint8_t yInBytes = 0; yInBytes < heightInBytes; yInBytes++)
+
+  // the zero extension is thicker than the zero bar for near-zero values,
+  // to distinguish the different near-zero values from each other
+  valueZeroExtensionStartX = constrain(intValue - 2 * ZERO_BAR_MAX_X, -ZERO_BAR_MAX_X, 0);
+  valueZeroExtensionEndX = constrain(intValue + 2 * ZERO_BAR_MAX_X, 0, ZERO_BAR_MAX_X);
+
+  if (!previousValueDisplayed)
   {
-    displayYSegment(startX, endX, yInBytes);
+    calculateTickColumns();
   }
-  if (additionalZeroExtension)
+  markDirty();
+}
+
+/**
+ * Sends the changed columns of the bar graph on a display page.
+ * 
+ * @param yInBytes the display page to send.
+ */
+void BarFieldConfiguration::renderPage(uint8_t yInBytes)
+{
+  if (additionalZeroExtension && yInBytes + 1 == yOffsetInBytes)
   {
-    displayZeroExtension(intValue);    
+    displayZeroExtension();
+    return;
   }
+  if (yInBytes < yOffsetInBytes || yInBytes >= yOffsetInBytes + heightInBytes)
+  {
+    return;
+  }
+  yInBytes -= yOffsetInBytes;
+  if (!previousValueDisplayed)
+  {
+    displayYSegment(0, widthInPx - 1, yInBytes);
+    return;
+  }
+  // both the previous and the new bar contain middleX, so they can only differ at their ends
+  if (valueStartX != previousStartX)
+  {
+    displayYSegment(min(valueStartX, previousStartX), max(valueStartX, previousStartX) - 1, yInBytes);
+  }
+  if (valueEndX != previousEndX)
+  {
+    displayYSegment(min(valueEndX, previousEndX) + 1, max(valueEndX, previousEndX), yInBytes);
+  }
+}
+
+/**
+ * Remembers the value set by setValue() as displayed, after all pages are rendered.
+ */
+void BarFieldConfiguration::finishRender()
+{
+  previousStartX = valueStartX;
+  previousEndX = valueEndX;
+  previousZeroExtensionStartX = valueZeroExtensionStartX;
+  previousZeroExtensionEndX = valueZeroExtensionEndX;
+  previousValueDisplayed = true;
 }
 
 /**
- * Displays a y segment (8 px) of the graph which displays the elongated zero bar.
+ * Fills the tickColumns table, marking the columns at which the bar has tick marks:
+ * Every TICK_DISTANCE px from the middle, with a width of 2 * ZERO_BAR_MAX_X + 1 px.
+ */
+void BarFieldConfiguration::calculateTickColumns()
+{
+  int16_t middleX = getMiddleX();
+  for (int16_t x = 0; x < widthInPx; x++)
+  {
+    uint8_t modulusX = abs(x - middleX) % TICK_DISTANCE;
+    if (modulusX <= ZERO_BAR_MAX_X || modulusX >= TICK_DISTANCE - ZERO_BAR_MAX_X)
+    {
+      tickColumns[x / 8] |= 0x01 << (x % 8);
+    }
+    else
+    {
+      tickColumns[x / 8] &= ~(0x01 << (x % 8));
+    }
+  }
+}
+
+/**
+ * Displays columns of a y segment (8 px) of the graph, showing the bar set by setValue().
  * 
- * @param startX the x value where the displayed bar begins, relative to xOffsetInPx
- * @param endX the x value where the displayed bar ends, relative to xOffsetInPx. Must be >= startX.
+ * @param fromX the first column to display, relative to xOffsetInPx
+ * @param toX the last column to display, relative to xOffsetInPx. Must be >= fromX.
  * @param yInBytes the y position of the segment to display in bytes (8 px) relative to yOffsetInBytes
  */
-// display the y segment of the graph which displays the elongated zero bar
-void BarFieldConfiguration::displayYSegment(int16_t startX, int16_t endX, uint8_t yInBytes)
+void BarFieldConfiguration::displayYSegment(int16_t fromX, int16_t toX, uint8_t yInBytes)
 {
   uint8_t nonModulusValue;
   if (yInBytes * 2 + 1 > heightInBytes)
@@ -133,82 +556,53 @@ void BarFieldConfiguration::displayYSegment(int16_t startX, int16_t endX, uint8_
     nonModulusValue = 0x00;
   }
 
-  int16_t middleX = getMiddleX();
-  display.position(xOffsetInPx, yOffsetInBytes + yInBytes);
-  display.dataMode();
-  display.chipSelect();
-  for (int16_t x = 0; x < widthInPx; x++)
+  display->startUpdate(xOffsetInPx + fromX, yOffsetInBytes + yInBytes);
+  for (int16_t x = fromX; x <= toX; x++)
   {
     uint8_t toSend;
-    if (x < startX || x > endX)
+    if (x < valueStartX || x > valueEndX)
     {
       // outside displayed bar
       toSend = 0x00;
     }
+    else if (tickColumns[x / 8] & (0x01 << (x % 8)))
+    {
+      // inside displayed bar, at a tick mark
+      toSend = 0xFF;
+    }
     else
     {
-      // inside displayed bar
-      uint8_t modulusX = abs(x - middleX) % 20;
-      if (modulusX <= ZERO_BAR_MAX_X || modulusX >= 20 - ZERO_BAR_MAX_X)
-      {
-        toSend = 0xFF;
-      }
-      else
-      {
-        toSend = nonModulusValue;
-      }
+      // inside displayed bar, between tick marks
+      toSend = nonModulusValue;
     }
-    display.sendToSpi(toSend);
+    display->update(toSend);
   }
-  display.chipDeselect();
 }
 
 /**
- * Displays the y segment of the graph belonging to the elongated zero bar.
- * To distinguish the different near-zero values from each other, the elongation is thicker than the zero bar
- * for near-zero values. For values far from the zero bar, the elongation is as thick as the zero bar.
- * 
- * @param xRelativeToMiddleX the parsed value of the field which should be displayed.
+ * Displays the y segment of the graph belonging to the elongated zero bar, above the field.
+ * Nothing is sent to the display if the elongation does not change.
  */
-void BarFieldConfiguration::displayZeroExtension(int16_t xRelativeToMiddleX)
+void BarFieldConfiguration::displayZeroExtension()
 {
-  // all x values are relative to middleX + xOffsetInPx here
-  
-  int16_t startX = xRelativeToMiddleX - 2 * ZERO_BAR_MAX_X;
-  if (startX > 0)
-  {
-    startX = 0;
-  }
-  if (startX < -ZERO_BAR_MAX_X)
+  if (previousValueDisplayed && valueZeroExtensionStartX == previousZeroExtensionStartX && valueZeroExtensionEndX == previousZeroExtensionEndX)
   {
-    startX = -ZERO_BAR_MAX_X;
+    return;
   }
 
-  int16_t endX = xRelativeToMiddleX + 2 * ZERO_BAR_MAX_X;
-  if (endX < 0)
-  {
-    endX = 0;
-  }
-  if (endX > ZERO_BAR_MAX_X)
-  {
-    endX = ZERO_BAR_MAX_X;
-  }
-
-  display.position(xOffsetInPx + getMiddleX() - ZERO_BAR_MAX_X, yOffsetInBytes - 1);
-  display.dataMode();
-  display.chipSelect();
+  // all x values are relative to middleX + xOffsetInPx here
+  display->startUpdate(xOffsetInPx + getMiddleX() - ZERO_BAR_MAX_X, yOffsetInBytes - 1);
   for (int16_t x = -ZERO_BAR_MAX_X; x <= ZERO_BAR_MAX_X; x++)
   {
-    if (x < startX || x > endX)
+    if (x < valueZeroExtensionStartX || x > valueZeroExtensionEndX)
     {
-      display.sendToSpi(0x00);
+      display->update(0x00);
     }
     else
     {
-      display.sendToSpi(0xFF);
+      display->update(0xFF);
     }
   }
-  display.chipDeselect();
 }
 
 /**
@@ -11,12 +11,54 @@
 #include <gfxfont.h>
 
 #include "DogDisplay.h"
+#include "Font.h"
+#include "LatencyHistogram.h"
+#include "StringDisplay.h"
+
+// A FieldConfiguration is a field on the display whose value is set by setValue() and drawn later by a DisplayCompositor,
+// which asks all fields page by page to send their changed columns to the display
+// If setValue() is called again before the field is drawn, only the latest value is drawn and the earlier one is dropped
+class FieldConfiguration
+{
+  public:
+  DogDisplay *display;                 // the display where the field is displayed on
+  uint8_t priority = 0;                // (0..4) 0 for the most important fields. Under load, the field is drawn at most every minimum refresh interval * 2^priority
+  uint16_t minRefreshIntervalInMs = 0; // the minimum time between two draws of the field, values set in between are drawn when it has passed
+
+  virtual void setValue(const char *value, uint8_t length) = 0; // sets the value to display, the field is drawn by the next call to DisplayCompositor::render()
+  virtual void prepareRender();                  // called before the first page is rendered, to work out what changed since the last render
+  virtual void renderPage(uint8_t yInBytes) = 0; // sends the changed columns of the field on a display page using display->startUpdate() and display->update()
+  virtual void finishRender() = 0;               // called after all pages are rendered, the set value is now displayed
+  void setValueMicros(uint32_t valueMicros);     // called after setValue() with the micros() when the ';' ending the value's message was parsed, instead of when setValue() was called
+  boolean isDirty();                             // whether the field must be drawn: the value set by setValue() is not yet displayed, or redraw() was called
+  void redraw();                                 // makes the next render draw the whole field instead of the changed columns only
+  uint16_t getDroppedValueCount();               // how many values set by setValue() were replaced by a newer value before they were displayed
+  uint16_t getRenderCount();                     // how many times the field was drawn
+  uint32_t getRenderMicros();                    // how long drawing the field took in total, in microseconds
+  uint32_t getMaxRenderMicros();                 // how long drawing the field took at most, in microseconds
+  void countRender(uint32_t renderMicros);       // called by DisplayCompositor after drawing the field, with the time it took; the field is then no longer dirty
+  LatencyHistogram *getLatencyHistogram();       // the times from receiving values (see setValueMicros()) to the end of drawing them
+  void resetCounters();                          // sets the dropped value and render counters to zero and empties the latency histogram
+
+  protected:
+  boolean dirty = false;              // whether the value set by setValue() is not yet displayed
+  boolean redrawPending = false;      // whether redraw() was called since the field was last drawn
+  boolean previousValueDisplayed = false; // whether the field shows what it last drew, so only changed columns must be drawn
+  uint16_t droppedValueCount = 0;     // how many values set by setValue() were replaced by a newer value before they were displayed
+  uint16_t renderCount = 0;           // how many times the field was drawn
+  uint32_t renderMicros = 0;          // how long drawing the field took in total, in microseconds
+  uint32_t maxRenderMicros = 0;       // how long drawing the field took at most, in microseconds
+  uint32_t valueMicros = 0;           // when the value set by setValue() was received, see setValueMicros()
+  LatencyHistogram latencyHistogram;  // the times from receiving values to the end of drawing them
+
+  void markDirty();                   // marks the field as to be drawn and remembers when, counting a value which is not yet displayed as dropped
+};
 
 // A StringFieldConfiguration displays a value on the display as String
 // It occupies a rectangle on the sceen defined by xOffset, yOffset, width and height
 // It contains a font to display the value
 // It has a label (e.g. for displaying the name or the unit of the value), which is always displayed at the right of the field, using a bitmap
-class StringFieldConfiguration
+class StringFieldConfiguration : public FieldConfiguration
 {
   public:
   String unit;                // the text to display as the unit of the quantity in the field
@@ -24,20 +66,42 @@ class StringFieldConfiguration
   uint8_t yOffsetInBytes = 0; // the Y distance in bytes (8 pixel) from display start to the start of the field, 0 if the field starts right where the display starts
   uint16_t widthInPx;         // the X dimension of the field in pixel
   uint8_t heightInBytes;      // the Y dimension of the field in bytes (8 px)
-  GFXfont *gfxValueFont;      // the font used to display the value of the field
+  Font *valueFont;            // the font used to display the value of the field
+  boolean tabularDigits = false;       // whether digits are laid out in fixed slots as wide as the widest digit, so that a changed digit redraws only its slot
   uint8_t labelValueXDistanceInPx = 4; // Distance between the label and the displayed value, in x Direction, in px
   uint8_t labelBitmapWithInPx;         // the with of the label bitmap in px
   uint8_t labelBitmapHeightInBytes;    // the height of the label bitmap in Bytes (== height in px / 8)
   const uint8_t *labelBitmap;          // the bitmap containing the label (e.g containing the unit) of the field, as dog type bitmap (first row followed by second row ...)
-  DogDisplay display;                  // the display where the field is displayed on
   
-  void displayValue(String toDisplay); // displays the passed String in the field
+  void setValue(const char *value, uint8_t length); // sets the characters to display in the field as pending value and marks the field dirty
+  void prepareRender();                // finds the columns which differ from the displayed value
+  void renderPage(uint8_t yInBytes);   // sends the changed columns of the value on a display page
+  void finishRender();                 // remembers the set value as displayed
   void displayUnit();                  // displays the unit bitmap of the field 
+
+  private:
+  // the maximum width of a field's value area in pixel
+  static const uint16_t MAX_VALUE_WIDTH_IN_PX = DISPLAY_WIDTH_IN_PX;
+  
+  char previousValue[StringDisplay::MAX_DISPLAYABLE_STRING_LENGTH];       // the characters of the last displayed value
+  uint8_t previousValueLength;                                            // the number of characters in previousValue
+  int16_t previousXOffsetInField;                                         // the x position in the field where the last displayed value started
+  char value[StringDisplay::MAX_DISPLAYABLE_STRING_LENGTH];               // the characters of the value set by setValue()
+  uint8_t valueLength;                                                    // the number of characters in value
+  uint8_t changedColumns[(MAX_VALUE_WIDTH_IN_PX + 7) / 8];                // one bit per column of the value area, set if the column must be redrawn
+  StringDisplay layout;                                                   // value laid out by prepareRender(), drawn page by page and remembered by finishRender()
+
+  int16_t getValueWidthInPx();
+  uint8_t getCharacterXAdvance(char c);
+  boolean hasPreviousLayout();
+  void updateChangedSlots(int16_t valueWidthInPx);
+  void markChangedColumns(StringDisplay &stringDisplay, int16_t xOffsetInField, int16_t valueWidthInPx);
+  void rememberValue(StringDisplay &stringDisplay, int16_t xOffsetInField);
 };
 
 // A BarFieldConfiguration displays a value on the display as a bar
 // It occupies a rectangle on the sceen defined by xOffset, yOffset, width and height=16px
-class BarFieldConfiguration
+class BarFieldConfiguration : public FieldConfiguration
 {
   public:
   String unit;                // the text to display as the unit of the quantity in the field
@@ -46,14 +110,28 @@ class BarFieldConfiguration
   uint16_t widthInPx = 201;   // the X dimension of the field in pixel
   uint8_t heightInBytes = 2;  // the Y dimension of the field in bytes (i.e. 8 px)
   boolean additionalZeroExtension = true; // whether to use another y byte at the zero mark to extend the zero mark upwards;
-  DogDisplay display;         // the display where the field is displayed on
   
-  void displayValue(String toDisplay); // parses the passed String as int and displays the parsed value on the bar graph. Negative values can be displayed as well.
+  void setValue(const char *value, uint8_t length); // parses the passed characters as int and sets the parsed value to display on the bar graph. Negative values can be displayed as well.
+  void renderPage(uint8_t yInBytes);   // sends the changed columns of the bar graph on a display page
+  void finishRender();                 // remembers the set value as displayed
 
   private:
   const int16_t ZERO_BAR_MAX_X = 2;                                           // how far the zero bar in the graph extends in x direction
-  void displayYSegment(int16_t startX, int16_t endX, uint8_t yOffsetInBytes); // displays a y segment (8 px high)of the graph
-  void displayZeroExtension(int16_t xRelativeToMiddleX);                      // display the y segment of the graph belonging to the elongated zero bar
+  const int16_t TICK_DISTANCE = 20;                                           // the distance in x direction between the tick marks of the graph
+  
+  int16_t previousStartX;                                                     // where the displayed bar begins, relative to xOffsetInPx
+  int16_t previousEndX;                                                       // where the displayed bar ends, relative to xOffsetInPx
+  int8_t previousZeroExtensionStartX;                                         // where the displayed zero extension begins, relative to the middle
+  int8_t previousZeroExtensionEndX;                                           // where the displayed zero extension ends, relative to the middle
+  int16_t valueStartX;                                                        // where the bar set by setValue() begins, relative to xOffsetInPx
+  int16_t valueEndX;                                                          // where the bar set by setValue() ends, relative to xOffsetInPx
+  int8_t valueZeroExtensionStartX;                                            // where the zero extension set by setValue() begins, relative to the middle
+  int8_t valueZeroExtensionEndX;                                              // where the zero extension set by setValue() ends, relative to the middle
+  uint8_t tickColumns[(DISPLAY_WIDTH_IN_PX + 7) / 8];                         // one bit per column of the field, set if a tick mark is at that column
+
+  void calculateTickColumns();                                                // fills the tickColumns table
+  void displayYSegment(int16_t fromX, int16_t toX, uint8_t yOffsetInBytes);  // displays columns of a y segment (8 px high) of the graph
+  void displayZeroExtension();                                                // display the y segment of the graph belonging to the elongated zero bar
   int16_t getMiddleX();                                                       // returns the x coordinate of the pixel in the middle of the field rectangle
 };
 
@@ -14,15 +14,32 @@
  * Constructor.
  * 
  * @param gfxfont the address of the GFX font definition in PGM space.
+ * @param fontMetrics the address of the precalculated metrics of the font in PGM space,
+ *        or NULL to calculate the metrics by scanning all glyphs of the font.
+ * @param pageFont the address of the glyphs of the font in display format in PGM space, or NULL if not available.
+ *        The page font must be generated for the baseline given in fontMetrics.
  */
-Font::Font(const GFXfont *gfxfont)
+Font::Font(const GFXfont *gfxfont, const FontMetrics *fontMetrics, const PageFont *pageFont)
 {
   this->gfxfont = gfxfont;
+  this->pageFont = pageFont;
 
   firstCharacterInFont = pgm_read_word(&(gfxfont->first));
   lastCharacterInFont = pgm_read_word(&(gfxfont->last));
   yAdvance = pgm_read_byte(&(gfxfont->yAdvance));
   bitmaps = pgm_read_ptr(&(gfxfont->bitmap));
+
+  if (fontMetrics != NULL)
+  {
+    yBaseline = pgm_read_byte(&(fontMetrics->yBaseline));
+    maxHeightAboveBaseline = pgm_read_byte(&(fontMetrics->maxHeightAboveBaseline));
+    maxDescentBelowBaseline = pgm_read_byte(&(fontMetrics->maxDescentBelowBaseline));
+    xAdvances = (const uint8_t *) pgm_read_ptr(&(fontMetrics->xAdvances));
+    maxDigitXAdvance = calculateMaxDigitXAdvance();
+    return;
+  }
+
+  xAdvances = NULL;
   maxHeightAboveBaseline = 0;
   maxDescentBelowBaseline = 0;
   
@@ -43,6 +60,7 @@ Font::Font(const GFXfont *gfxfont)
   // the baseline is chosen such that the maximum height and the maximum descent
   // has the same distance from the line height limits
   yBaseline = -maxHeightAboveBaseline - (yAdvance - maxHeightAboveBaseline - maxDescentBelowBaseline) / 2;
+  maxDigitXAdvance = calculateMaxDigitXAdvance();
 }
 
 /**
@@ -92,7 +110,88 @@ int8_t Font::getYAdvance()
   return yAdvance;
 }
 
+/**
+ * Returns the width of the space reserved for the character c.
+ * 
+ * @param c the character to return the width for.
+ *        Must be in the range firstCharacterInFont..lastCharacterInFont, this is NOT checked in the method.
+ */
+uint8_t Font::getXAdvance(char c)
+{
+  if (xAdvances != NULL)
+  {
+    return pgm_read_byte(xAdvances + (c - firstCharacterInFont));
+  }
+  GFXglyph *glyphConst = &(((GFXglyph *)pgm_read_ptr(&gfxfont->glyph))[c - firstCharacterInFont]);
+  return pgm_read_byte(&(glyphConst->xAdvance));
+}
+
+/**
+ * Returns the largest width of the space reserved for a digit 0..9,
+ * i.e. the width of a slot which can hold every digit. Returns 0 if the font contains no digits.
+ */
+uint8_t Font::getMaxDigitXAdvance()
+{
+  return maxDigitXAdvance;
+}
+
+/**
+ * Calculates the largest xAdvance of the digits 0..9 which are contained in the font.
+ */
+uint8_t Font::calculateMaxDigitXAdvance()
+{
+  uint8_t result = 0;
+  for (char c = '0'; c <= '9'; c++)
+  {
+    if (c >= firstCharacterInFont && c <= lastCharacterInFont)
+    {
+      result = max(result, getXAdvance(c));
+    }
+  }
+  return result;
+}
+
 uint8_t Font::getBitmapByte(GFXglyph gfxGlyph, uint16_t offsetInCharBitmap)
 {
   return (uint8_t)(pgm_read_byte(bitmaps + gfxGlyph.bitmapOffset + offsetInCharBitmap));
 }
+
+/**
+ * Returns whether the glyph for the character c is available in display format (see getPageColumns()).
+ * 
+ * @param c the character to check.
+ *        Must be in the range firstCharacterInFont..lastCharacterInFont, this is NOT checked in the method.
+ */
+bool Font::hasPageColumns(char c)
+{
+  if (pageFont == NULL)
+  {
+    return false;
+  }
+  const PageGlyph *pageGlyph = &(((const PageGlyph *)pgm_read_ptr(&pageFont->glyphs))[c - firstCharacterInFont]);
+  return pgm_read_byte(&(pageGlyph->pageCount)) > 0;
+}
+
+/**
+ * Returns the address in PGM space of the column bytes of one page of the glyph for the character c,
+ * i.e. gfxGlyph.width bytes for the x positions gfxGlyph.xOffset .. gfxGlyph.xOffset + gfxGlyph.width - 1 
+ * of the character. The LSB of each byte is the topmost pixel.
+ * Returns NULL if the page contains no pixels of the glyph.
+ * Must only be called if hasPageColumns(c) returns true.
+ * 
+ * @param c the character to return the page columns for.
+ * @param gfxGlyph the glyph of c, as returned by getGlyph(c).
+ * @param yInBytes the page, relative to the top of the line.
+ */
+const uint8_t *Font::getPageColumns(char c, GFXglyph gfxGlyph, uint8_t yInBytes)
+{
+  const PageGlyph *pageGlyph = &(((const PageGlyph *)pgm_read_ptr(&pageFont->glyphs))[c - firstCharacterInFont]);
+  uint8_t firstPage = pgm_read_byte(&(pageGlyph->firstPage));
+  uint8_t pageCount = pgm_read_byte(&(pageGlyph->pageCount));
+  if (yInBytes < firstPage || yInBytes >= firstPage + pageCount)
+  {
+    return NULL;
+  }
+  const uint8_t *data = (const uint8_t *)pgm_read_ptr(&pageFont->data);
+  return data + pgm_read_word(&(pageGlyph->dataOffset)) + (yInBytes - firstPage) * gfxGlyph.width;
+}
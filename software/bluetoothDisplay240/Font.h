@@ -11,14 +11,51 @@
 #include <Arduino.h>
 #include <gfxfont.h>
 
+/**
+ * Metrics of a GFX font which are calculated at build time by the font compiler (see software/fontCompiler),
+ * so they need not be calculated from the glyphs at runtime. Stored in PGM space.
+ */
+struct FontMetrics {
+  int8_t yBaseline;                // the position of the baseline (negative), see Font::getYBaseline()
+  int8_t maxHeightAboveBaseline;   // the maximum height in pixel of any glyph in the font above the baseline (positive)
+  int8_t maxDescentBelowBaseline;  // the maximum descent in pixel of any glyph in the font below the baseline (positive)
+  const uint8_t *xAdvances;        // the xAdvance of each character from first to last, in PGM space
+};
+
+/**
+ * Location of a glyph in a PageFont.
+ */
+struct PageGlyph {
+  uint16_t dataOffset;  // the offset of the first column byte of the glyph in PageFont.data
+  uint8_t firstPage;    // the first stored page (8 px high row), relative to the top of the line
+  uint8_t pageCount;    // how many pages of the glyph are stored, 0 if the glyph is not contained in the page font
+};
+
+/**
+ * Glyphs of a GFX font in display format, generated at build time by the font compiler (see software/fontCompiler).
+ * 
+ * Each glyph is stored page by page (8 px high rows, relative to the top of the line, already shifted to the baseline of the font),
+ * each page consists of GFXglyph.width column bytes for the x positions GFXglyph.xOffset .. GFXglyph.xOffset + GFXglyph.width - 1.
+ * The LSB of each column byte is the topmost pixel.
+ * Stored in PGM space.
+ */
+struct PageFont {
+  const uint8_t *data;        // the column bytes of all glyphs, in PGM space
+  const PageGlyph *glyphs;    // the location of each glyph from first to last character of the font in data, in PGM space
+};
+
 class Font {
   public:
     /**
      * Constructor.
      * 
      * @param gfxfont the address of the GFX font definition in PGM space.
+     * @param fontMetrics the address of the precalculated metrics of the font in PGM space,
+     *        or NULL to calculate the metrics by scanning all glyphs of the font.
+     * @param pageFont the address of the glyphs of the font in display format in PGM space, or NULL if not available.
+     *        The page font must be generated for the baseline given in fontMetrics.
      */
-    Font(const GFXfont *gfxfont);
+    Font(const GFXfont *gfxfont, const FontMetrics *fontMetrics = NULL, const PageFont *pageFont = NULL);
     
     /**
      * Returns the glyph (display definition) for the character c.
@@ -41,6 +78,20 @@ class Font {
      * which tells by how many pixel lines should be separated in y direction.
      */
     int8_t getYAdvance();
+
+    /**
+     * Returns the width of the space reserved for the character c.
+     * 
+     * @param c the character to return the width for.
+     *        Must be in the range firstCharacterInFont..lastCharacterInFont, this is NOT checked in the method.
+     */
+    uint8_t getXAdvance(char c);
+
+    /**
+     * Returns the largest width of the space reserved for a digit 0..9,
+     * i.e. the width of a slot which can hold every digit. Returns 0 if the font contains no digits.
+     */
+    uint8_t getMaxDigitXAdvance();
     
     /**
      * Return the byte in the bitmap for the glyph gfxGlyph, 
@@ -49,6 +100,27 @@ class Font {
      * No check is made whether one stays in the character's bitmap.
      */
     uint8_t getBitmapByte(GFXglyph gfxGlyph, uint16_t offsetInCharBitmap);
+
+    /**
+     * Returns whether the glyph for the character c is available in display format (see getPageColumns()).
+     * 
+     * @param c the character to check.
+     *        Must be in the range firstCharacterInFont..lastCharacterInFont, this is NOT checked in the method.
+     */
+    bool hasPageColumns(char c);
+
+    /**
+     * Returns the address in PGM space of the column bytes of one page of the glyph for the character c,
+     * i.e. gfxGlyph.width bytes for the x positions gfxGlyph.xOffset .. gfxGlyph.xOffset + gfxGlyph.width - 1 
+     * of the character. The LSB of each byte is the topmost pixel.
+     * Returns NULL if the page contains no pixels of the glyph.
+     * Must only be called if hasPageColumns(c) returns true.
+     * 
+     * @param c the character to return the page columns for.
+     * @param gfxGlyph the glyph of c, as returned by getGlyph(c).
+     * @param yInBytes the page, relative to the top of the line.
+     */
+    const uint8_t *getPageColumns(char c, GFXglyph gfxGlyph, uint8_t yInBytes);
    
   private:
     // The addresss of the gfxfont used by this Font object.
@@ -67,6 +139,12 @@ class Font {
     // From font definition: the address of the stored bitmaps
     uint8_t* bitmaps;
 
+    // the address of the glyphs in display format in PGM space, or NULL if not available
+    const PageFont *pageFont;
+
+    // From font metrics: the address of the xAdvance table in PGM space, or NULL if no font metrics are available
+    const uint8_t *xAdvances;
+
     // Calculated: the maximum height in pixel of any glyph in the font above the baseline (positive)
     int8_t maxHeightAboveBaseline;
     
@@ -75,6 +153,11 @@ class Font {
 
     // Calculated: the position of the baseline (negative)
     int8_t yBaseline;
+
+    // Calculated: the largest xAdvance of the digits 0..9
+    uint8_t maxDigitXAdvance;
+
+    uint8_t calculateMaxDigitXAdvance();
 };
 
 #endif
@@ -0,0 +1,20 @@
+// Generated by software/fontCompiler from FreeSansBold24pt7b.h, do not edit.
+
+#ifndef FREESANSBOLD24PT7B_METRICS_H
+#define FREESANSBOLD24PT7B_METRICS_H
+
+#include "Font.h"
+
+const uint8_t FreeSansBold24pt7bXAdvances[] PROGMEM = {
+    0x0D, 0x10, 0x16, 0x1A, 0x1A, 0x2A, 0x22, 0x0C, 0x10, 0x10, 0x12, 0x1B,
+    0x0C, 0x10, 0x0C, 0x0D, 0x1A, 0x1A, 0x1A, 0x1A, 0x1A, 0x1A, 0x1A, 0x1A,
+    0x1A, 0x1A, 0x0C, 0x0C, 0x1B, 0x1B, 0x1B, 0x1D, 0x2E, 0x21, 0x21, 0x22,
+    0x22, 0x1F, 0x1E, 0x24, 0x23, 0x0F, 0x1B, 0x22, 0x1D, 0x29, 0x23, 0x25,
+    0x20, 0x25, 0x22, 0x20, 0x1E, 0x23, 0x1F, 0x2D, 0x20, 0x1E, 0x1D, 0x10,
+    0x0D, 0x10, 0x1B, 0x1A, 0x0C, 0x1B, 0x1D, 0x1A, 0x1D, 0x1B, 0x10, 0x1D,
+    0x1C, 0x0D, 0x0D, 0x1B, 0x0D, 0x2A, 0x1D, 0x1D, 0x1D, 0x1D, 0x12, 0x1A,
+    0x10, 0x1D, 0x19, 0x25, 0x1A, 0x1A, 0x18, 0x12, 0x0D, 0x12, 0x17};
+
+const FontMetrics FreeSansBold24pt7bMetrics PROGMEM = {-39, 35, 12, FreeSansBold24pt7bXAdvances};
+
+#endif
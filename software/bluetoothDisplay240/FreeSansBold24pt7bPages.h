@@ -0,0 +1,221 @@
+// Generated by software/fontCompiler from FreeSansBold24pt7b.h, do not edit.
+
+#ifndef FREESANSBOLD24PT7B_PAGES_H
+#define FREESANSBOLD24PT7B_PAGES_H
+
+#include "Font.h"
+
+const PageGlyph FreeSansBold24pt7bPageGlyphs[] PROGMEM = {
+    {0, 0, 0},      // 0x20 not contained
+    {0, 0, 0},      // 0x21 not contained
+    {0, 0, 0},      // 0x22 not contained
+    {0, 0, 0},      // 0x23 not contained
+    {0, 0, 0},      // 0x24 not contained
+    {0, 0, 0},      // 0x25 not contained
+    {0, 0, 0},      // 0x26 not contained
+    {0, 0, 0},      // 0x27 not contained
+    {0, 0, 0},      // 0x28 not contained
+    {0, 0, 0},      // 0x29 not contained
+    {0, 0, 0},      // 0x2A not contained
+    {0, 0, 0},      // 0x2B not contained
+    {0, 0, 0},      // 0x2C not contained
+    {0, 3, 1},      // 0x2D '-'
+    {13, 4, 1},     // 0x2E '.'
+    {0, 0, 0},      // 0x2F not contained
+    {20, 0, 6},     // 0x30 '0'
+    {164, 0, 5},    // 0x31 '1'
+    {234, 0, 5},    // 0x32 '2'
+    {349, 0, 6},    // 0x33 '3'
+    {487, 0, 5},    // 0x34 '4'
+    {597, 0, 6},    // 0x35 '5'
+    {735, 0, 6},    // 0x36 '6'
+    {873, 0, 5},    // 0x37 '7'
+    {988, 0, 6},    // 0x38 '8'
+    {1132, 0, 6},   // 0x39 '9'
+    {1276, 1, 4},   // 0x3A ':'
+    {0, 0, 0},      // 0x3B not contained
+    {0, 0, 0},      // 0x3C not contained
+    {0, 0, 0},      // 0x3D not contained
+    {0, 0, 0},      // 0x3E not contained
+    {0, 0, 0},      // 0x3F not contained
+    {0, 0, 0},      // 0x40 not contained
+    {0, 0, 0},      // 0x41 not contained
+    {0, 0, 0},      // 0x42 not contained
+    {0, 0, 0},      // 0x43 not contained
+    {0, 0, 0},      // 0x44 not contained
+    {0, 0, 0},      // 0x45 not contained
+    {0, 0, 0},      // 0x46 not contained
+    {0, 0, 0},      // 0x47 not contained
+    {0, 0, 0},      // 0x48 not contained
+    {0, 0, 0},      // 0x49 not contained
+    {0, 0, 0},      // 0x4A not contained
+    {0, 0, 0},      // 0x4B not contained
+    {0, 0, 0},      // 0x4C not contained
+    {0, 0, 0},      // 0x4D not contained
+    {0, 0, 0},      // 0x4E not contained
+    {0, 0, 0},      // 0x4F not contained
+    {0, 0, 0},      // 0x50 not contained
+    {0, 0, 0},      // 0x51 not contained
+    {0, 0, 0},      // 0x52 not contained
+    {0, 0, 0},      // 0x53 not contained
+    {0, 0, 0},      // 0x54 not contained
+    {0, 0, 0},      // 0x55 not contained
+    {0, 0, 0},      // 0x56 not contained
+    {0, 0, 0},      // 0x57 not contained
+    {0, 0, 0},      // 0x58 not contained
+    {0, 0, 0},      // 0x59 not contained
+    {0, 0, 0},      // 0x5A not contained
+    {0, 0, 0},      // 0x5B not contained
+    {0, 0, 0},      // 0x5C not contained
+    {0, 0, 0},      // 0x5D not contained
+    {0, 0, 0},      // 0x5E not contained
+    {0, 0, 0},      // 0x5F not contained
+    {0, 0, 0},      // 0x60 not contained
+    {0, 0, 0},      // 0x61 not contained
+    {0, 0, 0},      // 0x62 not contained
+    {0, 0, 0},      // 0x63 not contained
+    {0, 0, 0},      // 0x64 not contained
+    {0, 0, 0},      // 0x65 not contained
+    {0, 0, 0},      // 0x66 not contained
+    {0, 0, 0},      // 0x67 not contained
+    {0, 0, 0},      // 0x68 not contained
+    {0, 0, 0},      // 0x69 not contained
+    {0, 0, 0},      // 0x6A not contained
+    {0, 0, 0},      // 0x6B not contained
+    {0, 0, 0},      // 0x6C not contained
+    {0, 0, 0},      // 0x6D not contained
+    {0, 0, 0},      // 0x6E not contained
+    {0, 0, 0},      // 0x6F not contained
+    {0, 0, 0},      // 0x70 not contained
+    {0, 0, 0},      // 0x71 not contained
+    {0, 0, 0},      // 0x72 not contained
+    {0, 0, 0},      // 0x73 not contained
+    {0, 0, 0},      // 0x74 not contained
+    {0, 0, 0},      // 0x75 not contained
+    {0, 0, 0},      // 0x76 not contained
+    {0, 0, 0},      // 0x77 not contained
+    {0, 0, 0},      // 0x78 not contained
+    {0, 0, 0},      // 0x79 not contained
+    {0, 0, 0},      // 0x7A not contained
+    {0, 0, 0},      // 0x7B not contained
+    {0, 0, 0},      // 0x7C not contained
+    {0, 0, 0},      // 0x7D not contained
+    {0, 0, 0},      // 0x7E not contained
+};
+
+const uint8_t FreeSansBold24pt7bPageData[] PROGMEM = {
+    0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F,
+    0x3F, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x80, 0x80, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0,
+    0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xE0, 0xF8, 0xFE,
+    0xFF, 0xFF, 0xFF, 0xFF, 0x3F, 0x1F, 0x0F, 0x0F, 0x0F, 0x0F, 0x1F, 0x3F,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xF8, 0xE0, 0x00, 0xFE, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0x3F, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xC0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3F, 0x00, 0x03, 0x0F, 0x3F,
+    0x7F, 0x7F, 0xFF, 0xFF, 0xFE, 0xFC, 0xF8, 0xF8, 0xF8, 0xF8, 0xFC, 0xFE,
+    0xFF, 0xFF, 0x7F, 0x7F, 0x3F, 0x0F, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x80, 0x80, 0x80, 0xE0, 0xE0,
+    0xE0, 0xE0, 0xF0, 0xF0, 0xF0, 0xF8, 0xFC, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x80, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0x80, 0x80, 0x80,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xE0, 0xF8, 0xFC, 0xFE, 0xFF, 0xFF, 0xFF,
+    0x3F, 0x1F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x1F, 0x7F, 0xFF, 0xFF, 0xFF,
+    0xFE, 0xFC, 0xF8, 0xE0, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0xC0, 0xF0, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x7F, 0x1F, 0x00, 0x00, 0x00, 0x80, 0xC0, 0xE0, 0xF0, 0xF8, 0xF8,
+    0xFC, 0xFE, 0x7F, 0x3F, 0x1F, 0x0F, 0x0F, 0x07, 0x03, 0x03, 0x01, 0x00,
+    0x00, 0x00, 0x00, 0xF0, 0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFD,
+    0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC, 0xFC,
+    0xFC, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x80, 0xC0, 0xC0, 0xC0, 0xC0,
+    0xC0, 0xC0, 0xC0, 0xC0, 0x80, 0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xE0, 0xFC, 0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0x3F, 0x1F, 0x0F, 0x0F, 0x0F,
+    0x0F, 0x1F, 0x3F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xFC, 0xF0, 0x00, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0xE0, 0xE0, 0xE0,
+    0xF0, 0xF8, 0xFF, 0xFF, 0xFF, 0xBF, 0x1F, 0x0F, 0x03, 0x00, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x03,
+    0x03, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xF8, 0x03, 0x1F, 0x3F,
+    0x7F, 0x7F, 0xFF, 0xFF, 0xFE, 0xFC, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xFC,
+    0xFF, 0xFF, 0xFF, 0x7F, 0x3F, 0x1F, 0x0F, 0x03, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xC0, 0xF0, 0xF8, 0xFE, 0x3F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0xE0, 0xF8, 0xFE, 0x3F, 0x0F, 0x07,
+    0x01, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00,
+    0x00, 0xFC, 0xFF, 0xFF, 0xFF, 0xF9, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8,
+    0xF8, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF8, 0xF8, 0xF8, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00, 0x00, 0x00, 0xF8, 0xFF,
+    0xFF, 0xFF, 0xFF, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F,
+    0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x00, 0xC0, 0xFE, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xF8, 0x7C, 0x7C, 0x7E, 0x7E, 0x7E, 0x7E, 0xFE, 0xFE, 0xFC, 0xFC,
+    0xFC, 0xF8, 0xF0, 0xE0, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x03, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0x0F, 0x1F, 0x3F, 0x7F, 0xFF, 0xFF, 0xFE,
+    0xFC, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xFC, 0xFE, 0xFF, 0xFF, 0x7F, 0x3F,
+    0x3F, 0x1F, 0x07, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x80, 0xC0,
+    0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0x80, 0x80, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xE0, 0xF8, 0xFC, 0xFE, 0xFF, 0xFF, 0xFF, 0x3F, 0x1F,
+    0x0F, 0x0F, 0x0F, 0x0F, 0x1F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3C, 0x38,
+    0x00, 0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF1, 0xF8, 0xF8, 0x7C,
+    0x7C, 0x7C, 0x7C, 0xFC, 0xFC, 0xF8, 0xF8, 0xF0, 0xF0, 0xE0, 0x80, 0x00,
+    0x3F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x03, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0x00,
+    0x03, 0x0F, 0x3F, 0x7F, 0x7F, 0xFF, 0xFF, 0xFC, 0xFC, 0xF8, 0xF8, 0xF8,
+    0xFC, 0xFC, 0xFF, 0xFF, 0xFF, 0x7F, 0x3F, 0x1F, 0x07, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x1F, 0x1F, 0x1F, 0x1F,
+    0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x9F, 0xDF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3F, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x80, 0xC0, 0xF0, 0xFC, 0xFE, 0xFF, 0xFF, 0x3F,
+    0x1F, 0x07, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xF0, 0xFC, 0xFF, 0xFF, 0xFF, 0xFF, 0x3F, 0x07, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x80,
+    0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0x80, 0x80, 0x80, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0xFC, 0xFE, 0xFF, 0xFF, 0xFF, 0x3F,
+    0x1F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x1F, 0x1F, 0x7F, 0xFF, 0xFF, 0xFE,
+    0xFC, 0xF0, 0x00, 0x00, 0x00, 0x03, 0x0F, 0x8F, 0xDF, 0xFF, 0xFF, 0xFC,
+    0xF8, 0xF0, 0xF0, 0xF0, 0xF0, 0xF0, 0xF8, 0xF8, 0xFE, 0xFF, 0xDF, 0xDF,
+    0x8F, 0x03, 0x00, 0x00, 0xF8, 0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x07,
+    0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x07, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFE, 0xF8, 0x03, 0x0F, 0x1F, 0x3F, 0x7F, 0xFF, 0xFF, 0xFF,
+    0xFC, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xFC, 0xFC, 0xFF, 0xFF, 0x7F, 0x7F,
+    0x3F, 0x1F, 0x0F, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x80,
+    0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0x80, 0x80, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xC0, 0xF0, 0xFC, 0xFE, 0xFF, 0xFF, 0xFF, 0x7F,
+    0x1F, 0x1F, 0x0F, 0x0F, 0x0F, 0x0F, 0x1F, 0x3F, 0x7F, 0xFF, 0xFF, 0xFE,
+    0xFC, 0xF8, 0xE0, 0x00, 0x3F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE0,
+    0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x80, 0xC0, 0xE0, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFE, 0x00, 0x01, 0x03, 0x07, 0x0F, 0x1F, 0x1F, 0x3F,
+    0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x1F, 0x0F, 0x87, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0x1F, 0x00, 0x0E, 0x3E, 0x7E, 0x7E, 0xFE, 0xFE, 0xFE,
+    0xFC, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xFC, 0xFE, 0xFF, 0x7F, 0x7F, 0x3F,
+    0x1F, 0x07, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x3F,
+    0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE};
+
+const PageFont FreeSansBold24pt7bPageFont PROGMEM = {FreeSansBold24pt7bPageData, FreeSansBold24pt7bPageGlyphs};
+
+// Approx. 1688 bytes
+
+#endif
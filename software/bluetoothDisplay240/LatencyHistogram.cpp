@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+#include "LatencyHistogram.h"
+
+/**
+ * Constructor, all buckets are empty.
+ */
+LatencyHistogram::LatencyHistogram()
+{
+  reset();
+}
+
+/**
+ * Counts a latency in its bucket.
+ *
+ * @param latencyMicros the latency in microseconds.
+ */
+void LatencyHistogram::add(uint32_t latencyMicros)
+{
+  // the bucket is the number of significant bits above the first bucket's limit
+  uint8_t bucket = 0;
+  latencyMicros >>= LATENCY_HISTOGRAM_FIRST_BUCKET_BITS;
+  while (latencyMicros != 0 && bucket < LATENCY_HISTOGRAM_BUCKETS - 1)
+  {
+    bucket++;
+    latencyMicros >>= 1;
+  }
+  if (counts[bucket] != 0xFFFF)
+  {
+    counts[bucket]++;
+  }
+}
+
+/**
+ * Returns how many latencies were counted in a bucket.
+ *
+ * @param bucket (0..LATENCY_HISTOGRAM_BUCKETS - 1) the bucket.
+ */
+uint16_t LatencyHistogram::getCount(uint8_t bucket)
+{
+  return counts[bucket];
+}
+
+/**
+ * Empties all buckets.
+ */
+void LatencyHistogram::reset()
+{
+  memset(counts, 0, sizeof(counts));
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <Arduino.h>
+
+#define LATENCY_HISTOGRAM_BUCKETS 12           // how many buckets a histogram has
+#define LATENCY_HISTOGRAM_FIRST_BUCKET_BITS 10 // bucket 0 counts latencies below 2^10 us, i.e. about 1 ms
+
+/**
+ * Counts latencies in buckets whose limits double from bucket to bucket, without allocating memory.
+ *
+ * Bucket 0 counts latencies below 1024 us, bucket i (1..LATENCY_HISTOGRAM_BUCKETS - 2) those from 2^(9 + i) us
+ * to below 2^(10 + i) us, i.e. 1 ms, 2 ms, 4 ms ... 512 ms to below twice as much,
+ * and the last bucket all latencies from 2^(9 + LATENCY_HISTOGRAM_BUCKETS - 1) us (about 1 s) on.
+ * The counts stop at their maximum instead of overflowing.
+ */
+class LatencyHistogram {
+  public:
+    /**
+     * Constructor, all buckets are empty.
+     */
+    LatencyHistogram();
+
+    /**
+     * Counts a latency in its bucket.
+     *
+     * @param latencyMicros the latency in microseconds.
+     */
+    void add(uint32_t latencyMicros);
+
+    /**
+     * Returns how many latencies were counted in a bucket.
+     *
+     * @param bucket (0..LATENCY_HISTOGRAM_BUCKETS - 1) the bucket.
+     */
+    uint16_t getCount(uint8_t bucket);
+
+    /**
+     * Empties all buckets.
+     */
+    void reset();
+
+  private:
+    // how many latencies were counted in each bucket
+    uint16_t counts[LATENCY_HISTOGRAM_BUCKETS];
+};
+
+#endif
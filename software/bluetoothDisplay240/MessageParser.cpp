@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+#include "MessageParser.h"
+
+/**
+ * Constructor.
+ *
+ * @param fieldsByNumber the fields by field number, field 1 at index 0. Entries may be NULL for unused numbers.
+ * @param fieldCount the number of entries in fieldsByNumber.
+ */
+MessageParser::MessageParser(FieldConfiguration *const *fieldsByNumber, uint8_t fieldCount)
+{
+  this->fieldsByNumber = fieldsByNumber;
+  this->fieldCount = fieldCount;
+  ackSequenceNumber = 0;
+  reset();
+  resetCounters();
+}
+
+/**
+ * Parses the next received character.
+ *
+ * @param c the received character.
+ * @return what the character completed, one of the MESSAGE_* constants.
+ */
+uint8_t MessageParser::parse(char c)
+{
+  if ((c < '0' || c > '9')
+      && (c < 'a' || c > 'z')
+      && (c < 'A' || c > 'Z')
+      && c != '.'
+      && c != '-'
+      && c != '?'
+      && c != ';'
+      && c != ','
+      && c != ':')
+  {
+    // ignore all unknown characters
+    ignoredCharacterCount++;
+    return MESSAGE_NONE;
+  }
+  lastCharacterMillis = millis();
+  if (c == ',')
+  {
+    // the next field value of the message follows
+    if (state == EXPECT_VALUE)
+    {
+      setFieldValue();
+    }
+    else if (state != EXPECT_FIELD_IDENTIFIER && state != EXPECT_COMMAND)
+    {
+      rejectedCount++;
+    }
+    // a command cannot be followed by field values, it is rejected at the end of the message
+    state = (state == EXPECT_COMMAND) ? SKIP_MESSAGE : EXPECT_FIELD_IDENTIFIER;
+    valueLength = 0;
+    return MESSAGE_NONE;
+  }
+  if (c == ';')
+  {
+    if (state == EXPECT_VALUE)
+    {
+      setFieldValue();
+    }
+    uint8_t result = MESSAGE_NONE;
+    if (fieldsSetInMessage != 0)
+    {
+      stampFieldValues();
+      result = MESSAGE_FIELD_VALUE;
+    }
+    else if (state == EXPECT_COMMAND)
+    {
+      result = parseCommand();
+    }
+    else if (state != EXPECT_FIELD_IDENTIFIER)
+    {
+      rejectedCount++;
+    }
+    if (result != MESSAGE_NONE)
+    {
+      messageCount++;
+    }
+    reset();
+    return result;
+  }
+
+  switch (state)
+  {
+    case EXPECT_FIELD_IDENTIFIER:
+      if (c == 'f')
+      {
+        state = EXPECT_FIELD_NUMBER;
+      }
+      else if (fieldsSetInMessage != 0)
+      {
+        state = SKIP_MESSAGE;
+      }
+      else
+      {
+        state = EXPECT_COMMAND;
+        value[valueLength++] = c;
+      }
+      break;
+    case EXPECT_FIELD_NUMBER:
+      state = SKIP_MESSAGE;
+      if (c >= '1' && c - '1' < fieldCount)
+      {
+        fieldIndex = c - '1';
+        if (fieldsByNumber[fieldIndex] != NULL)
+        {
+          state = EXPECT_COLON;
+        }
+      }
+      break;
+    case EXPECT_COLON:
+      state = (c == ':') ? EXPECT_VALUE : SKIP_MESSAGE;
+      break;
+    case EXPECT_VALUE:
+      if (valueLength < MESSAGE_PARSER_MAX_VALUE_LENGTH)
+      {
+        value[valueLength++] = c;
+      }
+      break;
+    case EXPECT_COMMAND:
+      if (valueLength < MESSAGE_PARSER_MAX_COMMAND_LENGTH)
+      {
+        value[valueLength++] = c;
+      }
+      break;
+    case SKIP_MESSAGE:
+      break;
+  }
+  return MESSAGE_NONE;
+}
+
+/**
+ * Discards a partially received message.
+ */
+void MessageParser::reset()
+{
+  state = EXPECT_FIELD_IDENTIFIER;
+  valueLength = 0;
+  fieldsSetInMessage = 0;
+}
+
+/**
+ * Passes the received value to the addressed field and remembers that the field was set by the message.
+ */
+void MessageParser::setFieldValue()
+{
+  fieldsByNumber[fieldIndex]->setValue(value, valueLength);
+  fieldsSetInMessage |= 0x01 << fieldIndex;
+}
+
+/**
+ * Sets the time the values of the message were received to now, when its terminating ';' is parsed,
+ * so that the latency of values which were set before a ',' also counts from the end of the message.
+ */
+void MessageParser::stampFieldValues()
+{
+  uint32_t now = micros();
+  for (uint8_t i = 0; i < fieldCount; i++)
+  {
+    if (fieldsSetInMessage & (0x01 << i))
+    {
+      fieldsByNumber[i]->setValueMicros(now);
+    }
+  }
+}
+
+/**
+ * Discards a partially received message and counts it as rejected if its last character was parsed 
+ * more than MESSAGE_PARSER_TIMEOUT_IN_MS ago, e.g. because its terminating ';' was lost.
+ * Values of the message which were already passed to fields are kept, and isBetweenMessages() returns true again.
+ * To be called when all received characters are parsed.
+ */
+void MessageParser::discardStaleMessage()
+{
+  if ((state == EXPECT_FIELD_IDENTIFIER && fieldsSetInMessage == 0) || millis() - lastCharacterMillis <= MESSAGE_PARSER_TIMEOUT_IN_MS)
+  {
+    return;
+  }
+  rejectedCount++;
+  reset();
+}
+
+/**
+ * Returns whether the last parsed character completed a message or was ignored between messages,
+ * i.e. whether no values of an incomplete message were passed to fields.
+ */
+boolean MessageParser::isBetweenMessages()
+{
+  return fieldsSetInMessage == 0;
+}
+
+/**
+ * Returns how many messages with field values or known commands were received.
+ */
+uint32_t MessageParser::getMessageCount()
+{
+  return messageCount;
+}
+
+/**
+ * Returns how many field values or commands were ignored because they were malformed or unknown.
+ */
+uint32_t MessageParser::getRejectedCount()
+{
+  return rejectedCount;
+}
+
+/**
+ * Returns how many received characters were ignored because they cannot be part of a message.
+ */
+uint32_t MessageParser::getIgnoredCharacterCount()
+{
+  return ignoredCharacterCount;
+}
+
+/**
+ * Sets the counters returned by getMessageCount(), getRejectedCount() and getIgnoredCharacterCount() to zero.
+ */
+void MessageParser::resetCounters()
+{
+  messageCount = 0;
+  rejectedCount = 0;
+  ignoredCharacterCount = 0;
+}
+
+/**
+ * Returns which command the received command message is, counting unknown commands as rejected.
+ *
+ * @return one of the MESSAGE_* constants, MESSAGE_NONE for unknown commands.
+ */
+uint8_t MessageParser::parseCommand()
+{
+  if (isCommand(PSTR(BINARY_MODE_REQUEST)))
+  {
+    return MESSAGE_BINARY_MODE_REQUEST;
+  }
+  if (isCommand(PSTR(STATISTICS_REQUEST)))
+  {
+    return MESSAGE_STATISTICS_REQUEST;
+  }
+  if (isCommand(PSTR(STATISTICS_RESET_REQUEST)))
+  {
+    return MESSAGE_STATISTICS_RESET_REQUEST;
+  }
+  if (isCommand(PSTR(LATENCY_REQUEST)))
+  {
+    return MESSAGE_LATENCY_REQUEST;
+  }
+  if (parseAckRequest())
+  {
+    return MESSAGE_ACK_REQUEST;
+  }
+  rejectedCount++;
+  return MESSAGE_NONE;
+}
+
+/**
+ * Returns whether the received command message is the given command.
+ *
+ * @param command the command in program memory, without the terminating ';'.
+ */
+boolean MessageParser::isCommand(const char *command)
+{
+  return valueLength == strlen_P(command) && !memcmp_P(value, command, valueLength);
+}
+
+/**
+ * Checks whether the received command message requests an answer, i.e. is ACK_REQUEST_PREFIX followed by 1..5 digits,
+ * and remembers its sequence number.
+ *
+ * @return whether the message requests an answer.
+ */
+boolean MessageParser::parseAckRequest()
+{
+  uint8_t prefixLength = sizeof(ACK_REQUEST_PREFIX) - 1;
+  if (valueLength <= prefixLength || valueLength > prefixLength + 5 || memcmp_P(value, PSTR(ACK_REQUEST_PREFIX), prefixLength))
+  {
+    return false;
+  }
+  uint32_t sequenceNumber = 0;
+  for (uint8_t i = prefixLength; i < valueLength; i++)
+  {
+    if (value[i] < '0' || value[i] > '9')
+    {
+      return false;
+    }
+    sequenceNumber = sequenceNumber * 10 + (value[i] - '0');
+  }
+  if (sequenceNumber > 0xFFFF)
+  {
+    return false;
+  }
+  ackSequenceNumber = sequenceNumber;
+  return true;
+}
+
+/**
+ * Returns the sequence number of the last message which requested an answer, e.g. 17 for "ack:17;".
+ */
+uint16_t MessageParser::getAckSequenceNumber()
+{
+  return ackSequenceNumber;
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+#ifndef MESSAGE_PARSER_H
+#define MESSAGE_PARSER_H
+
+#include <Arduino.h>
+
+#include "FieldConfiguration.h"
+
+#define MESSAGE_PARSER_MAX_VALUE_LENGTH StringDisplay::MAX_DISPLAYABLE_STRING_LENGTH // how many characters of a value are kept, further characters are dropped, as they cannot be displayed
+#define MESSAGE_PARSER_MAX_COMMAND_LENGTH 11 // how many characters of a command are kept, the longest command is "stats:reset"
+#define MESSAGE_PARSER_TIMEOUT_IN_MS 100    // a message whose next character does not arrive within this time is discarded by discardStaleMessage()
+
+// What a received character or byte completed, returned by MessageParser::parse() and BinaryFrameParser::parse()
+#define MESSAGE_NONE 0                     // nothing, the message is not yet complete
+#define MESSAGE_FIELD_VALUE 1              // a message whose value was passed to a field
+#define MESSAGE_BINARY_MODE_REQUEST 2      // the message "bin;", which requests to switch to binary frames
+#define MESSAGE_ASCII_MODE_REQUEST 3       // a binary frame which requests to switch back to ASCII messages
+#define MESSAGE_STATISTICS_REQUEST 4       // the message "stats?;", which requests the performance counters
+#define MESSAGE_STATISTICS_RESET_REQUEST 5 // the message "stats:reset;", which requests to reset the performance counters
+#define MESSAGE_LATENCY_REQUEST 6          // the message "lat?;", which requests the latency histograms
+#define MESSAGE_ACK_REQUEST 7              // a message like "ack:17;", which requests to be answered when all values received before are drawn
+
+// The commands are compared via PSTR(), so they stay in program memory
+#define BINARY_MODE_REQUEST "bin"                // the message which requests to switch to binary frames, without the terminating ';'
+#define STATISTICS_REQUEST "stats?"              // the message which requests the performance counters, without the terminating ';'
+#define STATISTICS_RESET_REQUEST "stats:reset"   // the message which requests to reset the performance counters, without the terminating ';'
+#define LATENCY_REQUEST "lat?"                   // the message which requests the latency histograms, without the terminating ';'
+#define ACK_REQUEST_PREFIX "ack:"                // the start of the message which requests an answer, followed by a sequence number (0..65535)
+
+/**
+ * Parses the messages received via bluetooth, one character at a time, without allocating memory.
+ *
+ * A message consists of the field identifier "f" followed by the field number (1..9), a colon (:),
+ * the value and a semicolon (;), e.g. "f1:12.3;".
+ * A message can also contain the values of several fields, separated by commas, e.g. "f1:12.3,f2:045,f3:-12;".
+ * Characters other than letters, digits, '.', '-', ':', '?', ',' and ';' are ignored.
+ * Field values with an unknown field identifier are ignored up to the next comma or semicolon.
+ * Each value is passed to the field with its field number as soon as it is complete.
+ * Between messages, isBetweenMessages() returns true, so all values of a message can be displayed together.
+ * The message "bin;" requests to switch to binary frames, see BinaryFrameParser.
+ * The messages "stats?;" and "stats:reset;" request to send and to reset the performance counters, "lat?;" the latency histograms.
+ * A message like "ack:17;" requests to be answered with the same message when all values received before are drawn,
+ * so the sender can measure the round trip time.
+ * If the terminating ';' of a message is lost, discardStaleMessage() ends the message once no character arrived 
+ * for MESSAGE_PARSER_TIMEOUT_IN_MS, so the values passed to fields are displayed.
+ */
+class MessageParser {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param fieldsByNumber the fields by field number, field 1 at index 0. Entries may be NULL for unused numbers.
+     * @param fieldCount the number of entries in fieldsByNumber.
+     */
+    MessageParser(FieldConfiguration *const *fieldsByNumber, uint8_t fieldCount);
+
+    /**
+     * Parses the next received character.
+     *
+     * @param c the received character.
+     * @return what the character completed, one of the MESSAGE_* constants.
+     */
+    uint8_t parse(char c);
+
+    /**
+     * Discards a partially received message.
+     */
+    void reset();
+
+    /**
+     * Discards a partially received message and counts it as rejected if its last character was parsed 
+     * more than MESSAGE_PARSER_TIMEOUT_IN_MS ago, e.g. because its terminating ';' was lost.
+     * Values of the message which were already passed to fields are kept, and isBetweenMessages() returns true again.
+     * To be called when all received characters are parsed.
+     */
+    void discardStaleMessage();
+
+    /**
+     * Returns whether the last parsed character completed a message or was ignored between messages,
+     * i.e. whether no values of an incomplete message were passed to fields.
+     */
+    boolean isBetweenMessages();
+
+    /**
+     * Returns how many messages with field values or known commands were received.
+     */
+    uint32_t getMessageCount();
+
+    /**
+     * Returns how many field values or commands were ignored because they were malformed or unknown.
+     */
+    uint32_t getRejectedCount();
+
+    /**
+     * Returns how many received characters were ignored because they cannot be part of a message.
+     */
+    uint32_t getIgnoredCharacterCount();
+
+    /**
+     * Sets the counters returned by getMessageCount(), getRejectedCount() and getIgnoredCharacterCount() to zero.
+     */
+    void resetCounters();
+
+    /**
+     * Returns the sequence number of the last message which requested an answer, e.g. 17 for "ack:17;".
+     */
+    uint16_t getAckSequenceNumber();
+
+  private:
+    // the states of the parser, i.e. which part of the message is expected next
+    enum State : uint8_t
+    {
+      EXPECT_FIELD_IDENTIFIER,
+      EXPECT_FIELD_NUMBER,
+      EXPECT_COLON,
+      EXPECT_VALUE,
+      EXPECT_COMMAND,
+      SKIP_MESSAGE
+    };
+
+    // the fields by field number, field 1 at index 0
+    FieldConfiguration *const *fieldsByNumber;
+
+    // the number of entries in fieldsByNumber
+    uint8_t fieldCount;
+
+    // which part of the message is expected next
+    State state;
+
+    // the index in fieldsByNumber of the field addressed by the message being received
+    uint8_t fieldIndex;
+
+    // the characters of the value or command received so far
+    char value[max(MESSAGE_PARSER_MAX_VALUE_LENGTH, MESSAGE_PARSER_MAX_COMMAND_LENGTH)];
+
+    // how many characters are in value
+    uint8_t valueLength;
+
+    // one bit per index in fieldsByNumber, set if a value of the message being received was passed to the field
+    uint16_t fieldsSetInMessage;
+
+    // the millis() when the last character of the message being received was parsed
+    uint32_t lastCharacterMillis;
+
+    // how many messages with field values or known commands were received
+    uint32_t messageCount;
+
+    // how many field values or commands were ignored because they were malformed or unknown
+    uint32_t rejectedCount;
+
+    // how many received characters were ignored because they cannot be part of a message
+    uint32_t ignoredCharacterCount;
+
+    // the sequence number of the last message which requested an answer
+    uint16_t ackSequenceNumber;
+
+    void setFieldValue();
+    void stampFieldValues();
+    uint8_t parseCommand();
+    boolean isCommand(const char *command);
+    boolean parseAckRequest();
+};
+
+#endif
@@ -5,36 +5,100 @@
  * under the terms of the GNU General Public License version 2
  * as published by the Free Software Foundation.
  */
+#include <avr/pgmspace.h>
+
 #include "StringDisplay.h"
 #include "Font.h"
 
+uint8_t StringDisplay::characterColumns[StringDisplay::MAX_CHARACTER_WIDTH_IN_PX];
+
 /* 
  * Constructor.
  * 
- * @param gfxfont the font to use
- * @param toDisplay the String to display
+ * @param font the font to use. The font must live at least as long as this object.
+ * @param toDisplay the characters to display, need not be zero terminated
+ * @param length the number of characters to display. Characters beyond MAX_DISPLAYABLE_STRING_LENGTH are ignored.
+ * @param tabularDigits whether each digit is centered in a slot as wide as the widest digit of the font,
+ *        so that a digit always occupies the same columns, whatever digits precede it.
+ */
+StringDisplay::StringDisplay(Font *font, const char *toDisplay, uint8_t length, boolean tabularDigits)
+{
+  setString(font, toDisplay, length, tabularDigits);
+}
+
+/* 
+ * Constructor for an empty string, setString() lays out the string to display.
+ */
+StringDisplay::StringDisplay()
+{
+  font = NULL;
+  tabularDigits = false;
+  toDisplayLength = 0;
+  totalXWidthInPixel = 0;
+}
+
+/* 
+ * Lays out the string to display, replacing the previous string.
+ * 
+ * Fills the characters array with the characters to display
+ * and the startX array with the start X positions of each glyph. The glyphs are read from the font again when they are drawn,
+ * so they take no RAM.
  * 
- * Fills the glyph array with the glyphs of the character to display
- * and the startX array with the sztart X positions of each glyph.
+ * @param font the font to use. The font must live at least as long as this object.
+ * @param toDisplay the characters to display, need not be zero terminated
+ * @param length the number of characters to display. Characters beyond MAX_DISPLAYABLE_STRING_LENGTH are ignored.
+ * @param tabularDigits whether each digit is centered in a slot as wide as the widest digit of the font,
+ *        so that a digit always occupies the same columns, whatever digits precede it.
  */
-StringDisplay::StringDisplay(const GFXfont *gfxfont, String toDisplay)
+void StringDisplay::setString(Font *font, const char *toDisplay, uint8_t length, boolean tabularDigits)
 {
-  this->font = new Font(gfxfont);
-  toDisplayLength = min(toDisplay.length(), MAX_DISPLAYABLE_STRING_LENGTH);
+  this->font = font;
+  this->tabularDigits = tabularDigits;
+  toDisplayLength = min(length, MAX_DISPLAYABLE_STRING_LENGTH);
   totalXWidthInPixel = 0;
   for (uint8_t i = 0; i < toDisplayLength; ++i)
   {
     startX[i] = totalXWidthInPixel;
-    char c = toDisplay.charAt(i);
-    GFXglyph glyph = font->getGlyph(c);
-    glyphArray[i] = glyph;
-    totalXWidthInPixel += glyph.xAdvance;
+    char c = toDisplay[i];
+    characters[i] = c;
+    totalXWidthInPixel += getLaidOutGlyph(c).xAdvance;
+  }
+}
+
+/**
+ * Replaces the character at the given index of the displayed string without laying out the string again.
+ * The new character must take the same space as the replaced one, e.g. another digit if tabular digits are used,
+ * so that all characters keep their positions.
+ * 
+ * @param index (0..getLength() - 1) the index of the character.
+ * @param c the new character.
+ */
+void StringDisplay::setCharacter(uint8_t index, char c)
+{
+  characters[index] = c;
+}
+
+/**
+ * Returns the glyph for the character c, with a digit centered in a slot as wide as the widest digit if tabular digits are used.
+ */
+GFXglyph StringDisplay::getLaidOutGlyph(char c)
+{
+  GFXglyph glyph = font->getGlyph(c);
+  if (tabularDigits && isTabularDigit(c))
+  {
+    uint8_t slotWidth = font->getMaxDigitXAdvance();
+    glyph.xOffset += (slotWidth - glyph.xAdvance) / 2;
+    glyph.xAdvance = slotWidth;
   }
+  return glyph;
 }
 
-StringDisplay::~StringDisplay()
+/**
+ * Returns whether c is laid out in a slot of Font::getMaxDigitXAdvance() pixels if tabular digits are used.
+ */
+boolean StringDisplay::isTabularDigit(char c)
 {
-  free(this->font);
+  return c >= '0' && c <= '9';
 }
 
 /**
@@ -56,11 +120,11 @@ uint8_t StringDisplay::getBitAt(int16_t x, int16_t y)
 
   // calculate which glyph to use for the given x position
   uint8_t glyphNumber = 0;
-  while (startX[glyphNumber + 1] < x && glyphNumber < toDisplayLength - 1)
+  while (glyphNumber < toDisplayLength - 1 && startX[glyphNumber + 1] <= x)
   {
     glyphNumber++;
   }
-  GFXglyph glyph = glyphArray[glyphNumber];
+  GFXglyph glyph = getGlyph(glyphNumber);
 
   // calculate the x position within the space reserved for the character
   uint16_t xInChar = x - startX[glyphNumber];
@@ -105,3 +169,175 @@ uint16_t StringDisplay::getWidth()
 {
   return totalXWidthInPixel;
 }
+
+/**
+ * Starts streaming one page (8 pixel high row) of the string as column bytes.
+ * The columns are then returned one by one, from left to right, by nextColumn().
+ * 
+ * @param yInBytes the page to stream, 0 is the page at the top of the string.
+ * @param xStart (0..getWidth() - 1) the x coordinate of the first column to stream.
+ */
+void StringDisplay::startPage(uint8_t yInBytes, uint16_t xStart)
+{
+  streamedPage = yInBytes;
+  streamedCharacter = 0;
+  if (toDisplayLength == 0)
+  {
+    streamedColumn = 0;
+    return;
+  }
+  while (streamedCharacter < toDisplayLength - 1 && startX[streamedCharacter + 1] <= xStart)
+  {
+    streamedCharacter++;
+  }
+  streamedColumn = xStart - startX[streamedCharacter];
+  renderCharacterColumns(streamedCharacter);
+}
+
+/**
+ * Returns the next column byte of the page started by startPage().
+ * The LSB of the returned byte is the topmost pixel.
+ * Must not be called more than getWidth() - xStart times after startPage().
+ */
+uint8_t StringDisplay::nextColumn()
+{
+  while (streamedColumn >= streamedGlyph.xAdvance)
+  {
+    if (streamedCharacter >= toDisplayLength - 1)
+    {
+      return 0;
+    }
+    streamedCharacter++;
+    streamedColumn = 0;
+    renderCharacterColumns(streamedCharacter);
+  }
+  uint8_t column = streamedColumn++;
+  if (streamedFromPageFont)
+  {
+    int16_t xInBitmap = column - streamedGlyph.xOffset;
+    if (pageFontColumns == NULL || xInBitmap < 0 || xInBitmap >= streamedGlyph.width)
+    {
+      return 0;
+    }
+    return pgm_read_byte(pageFontColumns + xInBitmap);
+  }
+  if (column >= MAX_CHARACTER_WIDTH_IN_PX)
+  {
+    return 0;
+  }
+  return characterColumns[column];
+}
+
+/**
+ * Reads the glyph of a character into streamedGlyph and renders the streamed page of the space reserved for the character into characterColumns.
+ * 
+ * If the font contains the glyph in display format, nothing is rendered, 
+ * nextColumn() then reads the column bytes directly from the font.
+ * Otherwise the glyph bitmap is read row by row with a running bit cursor, 
+ * only the rows which intersect the streamed page are read.
+ * 
+ * @param index the index of the character in the string.
+ */
+void StringDisplay::renderCharacterColumns(uint8_t index)
+{
+  streamedGlyph = getGlyph(index);
+  GFXglyph glyph = streamedGlyph;
+  streamedFromPageFont = font->hasPageColumns(characters[index]);
+  if (streamedFromPageFont)
+  {
+    pageFontColumns = font->getPageColumns(characters[index], glyph, streamedPage);
+    return;
+  }
+
+  memset(characterColumns, 0, MAX_CHARACTER_WIDTH_IN_PX);
+  int16_t xEnd = min(glyph.xAdvance, MAX_CHARACTER_WIDTH_IN_PX);
+
+  // rows of the glyph bitmap which intersect the streamed page
+  int16_t yPageTopInBitmap = streamedPage * 8 - (glyph.yOffset - font->getYBaseline());
+  int16_t firstRow = max(yPageTopInBitmap, 0);
+  int16_t endRow = min(yPageTopInBitmap + 8, glyph.height);
+  if (firstRow >= endRow)
+  {
+    return;
+  }
+
+  // walk the bitmap byte by byte, keeping track of the bitmap row and column of the MSB of each byte.
+  // Bytes without set bits are skipped as a whole.
+  uint16_t bitOffset = firstRow * glyph.width;
+  uint16_t bitmapByteOffset = bitOffset / 8;
+  int16_t row = firstRow;
+  int16_t xInBitmap = -(int16_t)(bitOffset % 8);
+  uint8_t bitmapByte = font->getBitmapByte(glyph, bitmapByteOffset++) & (0xFF >> (bitOffset % 8));
+  while (row < endRow)
+  {
+    int16_t xOfBit = xInBitmap;
+    int16_t rowOfBit = row;
+    for (uint8_t bitMask = 0x80; bitmapByte != 0; bitMask >>= 1)
+    {
+      while (xOfBit >= glyph.width)
+      {
+        xOfBit -= glyph.width;
+        rowOfBit++;
+      }
+      if (bitmapByte & bitMask)
+      {
+        bitmapByte &= ~bitMask;
+        int16_t x = glyph.xOffset + xOfBit;
+        if (rowOfBit < endRow && x >= 0 && x < xEnd)
+        {
+          characterColumns[x] |= 0x01 << (rowOfBit - yPageTopInBitmap);
+        }
+      }
+      xOfBit++;
+    }
+
+    xInBitmap += 8;
+    while (xInBitmap >= glyph.width)
+    {
+      xInBitmap -= glyph.width;
+      row++;
+    }
+    if (row < endRow)
+    {
+      bitmapByte = font->getBitmapByte(glyph, bitmapByteOffset++);
+    }
+  }
+}
+
+/**
+ * Returns the number of characters of the displayed string.
+ */
+uint8_t StringDisplay::getLength()
+{
+  return toDisplayLength;
+}
+
+/**
+ * Returns the character at the given index of the displayed string.
+ * 
+ * @param index (0..getLength() - 1) the index of the character.
+ */
+char StringDisplay::getCharacter(uint8_t index)
+{
+  return characters[index];
+}
+
+/**
+ * Returns the glyph of the character at the given index of the displayed string, as laid out. Reads the glyph from the font.
+ * 
+ * @param index (0..getLength() - 1) the index of the character.
+ */
+GFXglyph StringDisplay::getGlyph(uint8_t index)
+{
+  return getLaidOutGlyph(characters[index]);
+}
+
+/**
+ * Returns the x offset of the space reserved for the character at the given index of the displayed string.
+ * 
+ * @param index (0..getLength() - 1) the index of the character.
+ */
+uint16_t StringDisplay::getStartX(uint8_t index)
+{
+  return startX[index];
+}
@@ -18,8 +18,33 @@
  */
 class StringDisplay {
   public:
-    StringDisplay(const GFXfont *gfxfont, String toDisplay);
-    ~StringDisplay();
+    StringDisplay(Font *font, const char *toDisplay, uint8_t length, boolean tabularDigits = false);
+
+    StringDisplay();
+
+    /**
+     * Lays out the string to display, replacing the previous string.
+     * 
+     * @param font the font to use. The font must live at least as long as this object.
+     * @param toDisplay the characters to display, need not be zero terminated
+     * @param length the number of characters to display. Characters beyond MAX_DISPLAYABLE_STRING_LENGTH are ignored.
+     * @param tabularDigits whether each digit is centered in a slot as wide as the widest digit of the font.
+     */
+    void setString(Font *font, const char *toDisplay, uint8_t length, boolean tabularDigits = false);
+
+    /**
+     * Replaces the character at the given index of the displayed string without laying out the string again.
+     * The new character must take the same space as the replaced one, e.g. another digit if tabular digits are used.
+     * 
+     * @param index (0..getLength() - 1) the index of the character.
+     * @param c the new character.
+     */
+    void setCharacter(uint8_t index, char c);
+
+    /**
+     * Returns whether c is laid out in a slot of Font::getMaxDigitXAdvance() pixels if tabular digits are used.
+     */
+    static boolean isTabularDigit(char c);
 
     /**
      * Calculates a bit of the bitmap of the string which should be displayed.
@@ -36,25 +61,102 @@ class StringDisplay {
      */
     uint16_t getWidth();
 
+    /**
+     * Starts streaming one page (8 pixel high row) of the string as column bytes.
+     * The columns are then returned one by one, from left to right, by nextColumn().
+     * 
+     * @param yInBytes the page to stream, 0 is the page at the top of the string.
+     * @param xStart (0..getWidth() - 1) the x coordinate of the first column to stream.
+     */
+    void startPage(uint8_t yInBytes, uint16_t xStart = 0);
+
+    /**
+     * Returns the next column byte of the page started by startPage().
+     * The LSB of the returned byte is the topmost pixel.
+     * Must not be called more than getWidth() - xStart times after startPage().
+     */
+    uint8_t nextColumn();
+
+    /**
+     * Returns the number of characters of the displayed string.
+     */
+    uint8_t getLength();
+
+    /**
+     * Returns the character at the given index of the displayed string.
+     * 
+     * @param index (0..getLength() - 1) the index of the character.
+     */
+    char getCharacter(uint8_t index);
+
+    /**
+     * Returns the glyph of the character at the given index of the displayed string, as laid out. Reads the glyph from the font.
+     * 
+     * @param index (0..getLength() - 1) the index of the character.
+     */
+    GFXglyph getGlyph(uint8_t index);
+
+    /**
+     * Returns the x offset of the space reserved for the character at the given index of the displayed string.
+     * 
+     * @param index (0..getLength() - 1) the index of the character.
+     */
+    uint16_t getStartX(uint8_t index);
+
     /**
      * The maximum length in charcters of strings we can display.
+     * The widest value area of the fields (96 px) holds 8 of the narrowest characters of FreeSansBold24pt7b ('.', ':' and ',', 12 px each).
+     */
+    static const uint8_t MAX_DISPLAYABLE_STRING_LENGTH = 8;
+
+    /**
+     * The maximum width in pixel of the space reserved for one character.
+     * Wider characters are clipped by nextColumn().
      */
-    static const uint8_t MAX_DISPLAYABLE_STRING_LENGTH = 20;
+    static const uint8_t MAX_CHARACTER_WIDTH_IN_PX = 48;
     
   private:
-    // The font we use to display the string
+    // The font we use to display the string, not owned by this object
     Font *font;
     
+    // whether digits are centered in slots as wide as the widest digit of the font
+    boolean tabularDigits;
+
     // The length in characters of the string which we are displaying
     uint8_t toDisplayLength;
     
     // the width in pixel of the displayed string
     uint16_t totalXWidthInPixel;
     
-    // array of the font glyphs which display the single characters in the string
-    GFXglyph glyphArray[MAX_DISPLAYABLE_STRING_LENGTH];
-    
+    // the characters in the string
+    char characters[MAX_DISPLAYABLE_STRING_LENGTH];
+
     // array of x offsets of the spaces reserved for the characters in the string
     uint16_t startX[MAX_DISPLAYABLE_STRING_LENGTH];
+
+    // the page which is currently streamed by nextColumn()
+    uint8_t streamedPage;
+
+    // the index of the character which is currently streamed by nextColumn()
+    uint8_t streamedCharacter;
+
+    // the column in the space of the currently streamed character which nextColumn() returns next
+    uint8_t streamedColumn;
+
+    // the laid out glyph of the currently streamed character, read from the font once per character instead of once per column
+    GFXglyph streamedGlyph;
+
+    // the column bytes of the currently streamed page of the currently streamed character.
+    // Shared by all instances, as only one string is streamed at a time
+    static uint8_t characterColumns[MAX_CHARACTER_WIDTH_IN_PX];
+
+    // whether the currently streamed character is read directly from the page font instead of characterColumns
+    bool streamedFromPageFont;
+
+    // if streamedFromPageFont: the address in PGM space of the page font column bytes of the currently streamed page and character, or NULL for an empty page
+    const uint8_t *pageFontColumns;
+
+    void renderCharacterColumns(uint8_t index);
+    GFXglyph getLaidOutGlyph(char c);
 };
 #endif
@@ -8,16 +8,34 @@
 #include <Arduino.h>
 #include <SoftwareSerial.h>
 #include <SPI.h>
+#include <avr/sleep.h>
 #include "DogDisplay.h"
 #include "StringDisplay.h"
 #include "gfxfont.h"
 #include "FreeSansBold24pt7b.h"
+#include "FreeSansBold24pt7bMetrics.h"
+#include "FreeSansBold24pt7bPages.h"
 #include "FieldConfiguration.h"
+#include "DisplayCompositor.h"
+#include "MessageParser.h"
+#include "BinaryFrameParser.h"
+#include "LatencyHistogram.h"
+#include "Font.h"
 
-const uint8_t BLUETOOTH_BUFFER_SIZE = 30;
+// Set to 1 if the HM 17 module is connected to the hardware USART (RX = pin 0, TX = pin 1) instead of pins 5 and 6.
+// The hardware USART stores received bytes from its receive interrupt in a ring buffer 
+// (64 bytes, can be enlarged by building with -DSERIAL_RX_BUFFER_SIZE=128),
+// while SoftwareSerial blocks all interrupts for the whole time a byte is received.
+#ifndef BLUETOOTH_ON_HARDWARE_SERIAL
+#define BLUETOOTH_ON_HARDWARE_SERIAL 0
+#endif
+
+const uint16_t BATTERY_CHECK_INTERVAL_IN_MS = 5000;
 
 const GFXfont *gfxfont = &FreeSansBold24pt7b;
 
+Font valueFont(gfxfont, &FreeSansBold24pt7bMetrics, &FreeSansBold24pt7bPageFont);
+
 const uint8_t ktsBitmap[] PROGMEM = {
   0xE7, 0xE7, 0x76, 0x3E, 0x1E, 0x3E, 0xF6, 0xF6, 0x06, 0x07, 
   0x07, 0xE1, 0xF1, 0x30, 0x30, 0x30, 0x30, 0xF8, 0xF8, 0x30, 
@@ -33,30 +51,48 @@ const uint8_t degBitmap[] PROGMEM = {
   0x87, 0x03, 0x00, 0x00, 0x00, 0x1F, 0x3F, 0x30, 0x30, 0x37, 
   0x3F, 0x39, 0x30, 0x30, 0x39, 0x7F, 0x7F, 0x00, 0x00, 0x00}; // created using gfxutils with font FreeMonoBold9pt7
 
-const String VELOCITY_FIELD_PREFIX = "f1:";
-
-const String DIRECTION_STRING_FIELD_PREFIX = "f2:";
-
-const String DIRECTION_BAR_FIELD_PREFIX = "f3:";
-
-const uint8_t FIELD_PREFIX_LENGTH = 3;
-
 DogDisplay display;
 
+#if BLUETOOTH_ON_HARDWARE_SERIAL
+HardwareSerial &bluetooth = Serial;
+#else
 SoftwareSerial bluetooth(5, 6); // RX, TX
-
-char bluetoothReceiveBuffer[BLUETOOTH_BUFFER_SIZE];
- 
-uint8_t bluetoothReceiveBufferCursor = 0;
+#endif
 
 int16_t knots = 0;
 
+uint32_t lastBatteryCheckMillis = 0;
+
+boolean batteryChecked = false;
+
 StringFieldConfiguration velocityField;
 
 StringFieldConfiguration directionStringField;
 
 BarFieldConfiguration directionBarField;
 
+DisplayCompositor compositor(&display);
+
+// the fields addressed by the messages "f1:", "f2:" and "f3:"
+FieldConfiguration *const fieldsByNumber[] = {&velocityField, &directionStringField, &directionBarField};
+
+MessageParser messageParser(fieldsByNumber, sizeof(fieldsByNumber) / sizeof(fieldsByNumber[0]));
+
+BinaryFrameParser binaryFrameParser(fieldsByNumber, sizeof(fieldsByNumber) / sizeof(fieldsByNumber[0]));
+
+// whether binary frames are received instead of ASCII messages, switched by the "bin;" message and the ASCII mode request frame
+boolean binaryMode = false;
+
+// how often the receive buffer was found full after drawing, i.e. drawing did not keep up with receiving
+// and received bytes were probably dropped
+uint16_t receiveBufferFullCount = 0;
+
+// whether an "ack:<sequence number>;" message is to be answered as soon as all values received before it are drawn
+boolean ackPending = false;
+
+// the sequence number of the pending "ack:" message
+uint16_t ackSequenceNumber;
+
 void setup()
 {
   bluetooth.begin(9600);
@@ -64,25 +100,39 @@ void setup()
 
   velocityField.widthInPx = 107;
   velocityField.heightInBytes = 6;
-  velocityField.gfxValueFont = gfxfont;
+  velocityField.valueFont = &valueFont;
+  velocityField.tabularDigits = true;
   velocityField.labelBitmap = &ktsBitmap[0];
   velocityField.labelBitmapWithInPx = 11;
   velocityField.labelBitmapHeightInBytes = 4;
-  velocityField.display = display;
+  velocityField.display = &display;
   
   directionStringField.xOffsetInPx = 130;
   directionStringField.widthInPx = 110;
   directionStringField.heightInBytes = 6;
-  directionStringField.gfxValueFont = gfxfont;
+  directionStringField.valueFont = &valueFont;
+  directionStringField.tabularDigits = true;
   directionStringField.labelBitmap = &degBitmap[0];
   directionStringField.labelBitmapWithInPx = 15;
   directionStringField.labelBitmapHeightInBytes = 4;
-  directionStringField.display = display;
+  directionStringField.display = &display;
 
   directionBarField.yOffsetInBytes = 6;
   directionBarField.widthInPx = 201;
   directionBarField.heightInBytes = 2;
-  directionBarField.display = display;
+  directionBarField.display = &display;
+
+  // under load, the velocity is drawn at every render, the direction every second and the direction bar every fourth
+  velocityField.priority = 0;
+  directionStringField.priority = 1;
+  directionBarField.priority = 2;
+  // the bar is only glanced at for the trend, so it is drawn at most five times per second even without load,
+  // which leaves the render time to the values
+  directionBarField.minRefreshIntervalInMs = 200;
+
+  compositor.addField(&velocityField);
+  compositor.addField(&directionStringField);
+  compositor.addField(&directionBarField);
 
   displayNoBluetoothConnection();
   
@@ -90,107 +140,234 @@ void setup()
   
   directionStringField.displayUnit();
   
-  directionBarField.displayValue("0");
+  directionBarField.setValue("0", 1);
+  // draws the "No Con" values and the bar in one render, a second render would be delayed by the frame rate limit
+  compositor.render();
   
-  bluetooth.write("AT+NAMELCDDISPLAY\r\n");
+  bluetooth.print(F("AT+NAMELCDDISPLAY\r\n"));
   delay(1000);
-  receiveBluetooth();
-  clearBluetoothReceiveBuffer();
+  // discard the answer of the bluetooth module
+  while (bluetooth.available())
+  {
+    bluetooth.read();
+  }
 }
 
-//main loop
+// main loop, sleeps between its passes until the next interrupt, 
+// so that a received message is displayed as soon as it is complete
 void loop()
 {
-  uint8_t batteryFull = batteryChargingState();
-  display.drawBatterySymbol(230, 5, batteryFull);
+  // the battery level changes slowly, so it is only measured every BATTERY_CHECK_INTERVAL_IN_MS
+  if (!batteryChecked || millis() - lastBatteryCheckMillis >= BATTERY_CHECK_INTERVAL_IN_MS)
+  {
+    uint8_t batteryFull = batteryChargingState();
+    display.drawBatterySymbol(230, 5, batteryFull);
+    if (batteryChecked)
+    {
+      // repairs blocks whose change the shadow checksums missed, see DogDisplay
+      compositor.redraw();
+    }
+    lastBatteryCheckMillis = millis();
+    batteryChecked = true;
+  }
 
+  // the bytes which arrived while the display was drawn tell whether drawing keeps up with receiving
+  uint8_t receiveBacklog = bluetooth.available();
+#if BLUETOOTH_ON_HARDWARE_SERIAL
+  // HardwareSerial has no overflow flag, it drops received bytes silently once it holds SERIAL_RX_BUFFER_SIZE - 1 bytes,
+  // so only a full buffer can be seen, which may also have been filled exactly without losing a byte
+  if (receiveBacklog >= SERIAL_RX_BUFFER_SIZE - 1)
+#else
+  // SoftwareSerial drops a received byte only if its buffer is full
+  if (bluetooth.overflow())
+#endif
+  {
+    receiveBufferFullCount++;
+  }
   receiveBluetooth();
+  if (!binaryMode)
+  {
+    messageParser.discardStaleMessage();
+  }
+  // all fields which received a value are drawn together, 
+  // but not before all values of a message with several field values have arrived.
+  // Fields which are not drawn because of the frame rate limit are drawn by a later pass
+  if (binaryMode || messageParser.isBetweenMessages())
+  {
+    compositor.render(receiveBacklog);
+  }
+  if (ackPending && !compositor.isDirty())
+  {
+    bluetooth.print(F("ack:"));
+    bluetooth.print(ackSequenceNumber);
+    bluetooth.write(';');
+    ackPending = false;
+  }
+
+  sleepUntilInterrupt();
+}
+
+/**
+ * Puts the CPU into idle sleep until the next interrupt, unless received bytes are waiting.
+ * 
+ * In idle sleep, only the CPU clock stops: the millis() timer wakes the CPU every 1024 us, 
+ * so the battery check and fields deferred by the frame rate limit still run on time,
+ * and the receive interrupt of the USART or the pin change interrupt of SoftwareSerial wakes it as soon as a byte arrives.
+ * Deeper sleep modes would stop millis(), and the oscillator start-up would lose the first received byte.
+ */
+void sleepUntilInterrupt()
+{
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  cli();
+  if (bluetooth.available())
+  {
+    sei();
+    return;
+  }
+  sleep_enable();
+  // the instruction after sei() is executed before any pending interrupt, so a byte received after the check above wakes the CPU
+  sei();
+  sleep_cpu();
+  sleep_disable();
 }
 
 void receiveBluetooth()
 {
   if (!bluetooth.available())
   {
-    delay(100);
     return;
   }
   
   while (bluetooth.available())
   {
-    char readFromBluetooth = bluetooth.read();
-    //bluetooth.write(readFromBluetooth);
-    if ((readFromBluetooth < '0' || readFromBluetooth > '9')
-        && (readFromBluetooth < 'a' || readFromBluetooth > 'z')
-        && (readFromBluetooth < 'A' || readFromBluetooth > 'Z')
-        && readFromBluetooth!='.' 
-        && readFromBluetooth!='-' 
-        && readFromBluetooth!=';'
-        && readFromBluetooth!=':')
-    {
-      // ignore all unknown characters
-      continue;
-    }
-    if (readFromBluetooth == ';')
-    {
-      readFromBluetooth='\0';
-    }
-    bluetoothReceiveBuffer[bluetoothReceiveBufferCursor]=readFromBluetooth;
-    String toDisplay = bluetoothReceiveBuffer;
-    if (readFromBluetooth == '\0' || bluetoothReceiveBufferCursor >= BLUETOOTH_BUFFER_SIZE - 1)
+    uint8_t received = bluetooth.read();
+    if (binaryMode)
     {
-      toDisplay = bluetoothReceiveBuffer;
-      determineFieldAndDisplayString(toDisplay);
-      clearBluetoothReceiveBuffer();
+      if (binaryFrameParser.parse(received) == MESSAGE_ASCII_MODE_REQUEST)
+      {
+        binaryMode = false;
+        messageParser.reset();
+      }
     }
     else
     {
-      bluetoothReceiveBufferCursor++;
+      switch (messageParser.parse(received))
+      {
+        case MESSAGE_BINARY_MODE_REQUEST:
+          // acknowledge, the sender starts sending binary frames after receiving this
+          bluetooth.print(F("bin:ok;"));
+          binaryMode = true;
+          binaryFrameParser.reset();
+          break;
+        case MESSAGE_STATISTICS_REQUEST:
+          sendStatistics();
+          break;
+        case MESSAGE_STATISTICS_RESET_REQUEST:
+          resetStatistics();
+          bluetooth.print(F("stats:ok;"));
+          break;
+        case MESSAGE_LATENCY_REQUEST:
+          sendLatencyHistograms();
+          break;
+        case MESSAGE_ACK_REQUEST:
+          // answered by loop() after the values received before are drawn; a newer request replaces a pending one
+          ackSequenceNumber = messageParser.getAckSequenceNumber();
+          ackPending = true;
+          break;
+      }
     }
   }
-  //bluetooth.write(bluetoothReceiveBuffer);
 }
 
-void clearBluetoothReceiveBuffer() 
+/**
+ * Sends the performance counters as answer to the "stats?;" message, e.g.
+ * "stats:msg=12,rej=0,ign=2,full=0,crc=0,lost=0,spi=4711,pos=80,skip=320,f1=5/1/10240/2536,f2=...,f3=...;":
+ * the received messages, the rejected field values and commands, the ignored characters, the receive buffer full events,
+ * the corrupted and the lost binary frames, the bytes sent to the display, the position commands, the bytes not sent because they were unchanged,
+ * and per field the renders, the values replaced before they were drawn, and the total and the maximum render time in microseconds.
+ */
+void sendStatistics()
 {
-  bluetoothReceiveBufferCursor = 0;
-  for (uint8_t i = 0; i < BLUETOOTH_BUFFER_SIZE; i++)
+  bluetooth.print(F("stats:msg="));
+  bluetooth.print(messageParser.getMessageCount());
+  bluetooth.print(F(",rej="));
+  bluetooth.print(messageParser.getRejectedCount());
+  bluetooth.print(F(",ign="));
+  bluetooth.print(messageParser.getIgnoredCharacterCount());
+  bluetooth.print(F(",full="));
+  bluetooth.print(receiveBufferFullCount);
+  bluetooth.print(F(",crc="));
+  bluetooth.print(binaryFrameParser.getCorruptedFrameCount());
+  bluetooth.print(F(",lost="));
+  bluetooth.print(binaryFrameParser.getLostFrameCount());
+  bluetooth.print(F(",spi="));
+  bluetooth.print(display.getSpiByteCount());
+  bluetooth.print(F(",pos="));
+  bluetooth.print(display.getPositionCount());
+  bluetooth.print(F(",skip="));
+  bluetooth.print(display.getSkippedByteCount());
+  for (uint8_t i = 0; i < sizeof(fieldsByNumber) / sizeof(fieldsByNumber[0]); i++)
   {
-    bluetoothReceiveBuffer[i] = '\0';
+    FieldConfiguration *field = fieldsByNumber[i];
+    bluetooth.print(F(",f"));
+    bluetooth.print(i + 1);
+    bluetooth.write('=');
+    bluetooth.print(field->getRenderCount());
+    bluetooth.write('/');
+    bluetooth.print(field->getDroppedValueCount());
+    bluetooth.write('/');
+    bluetooth.print(field->getRenderMicros());
+    bluetooth.write('/');
+    bluetooth.print(field->getMaxRenderMicros());
   }
+  bluetooth.write(';');
 }
 
 /**
- * Displays a prefixed String.
- * 
- * The field to display the value in is determined by the prefix, which should be any of the constants
- * <code>VELOCITY_FIELD_PREFIX</code>, <code>DIRECTION_STRING_FIELD_PREFIX</code>. 
- * or <code>DIRECTION_BAR_FIELD_PREFIX</code>.
- * 
- * The displayed value is then the passed String with the prefix removed.
- * If no prefix is recognized, the passed String is displayed as is in the directionStringField.
- * 
- * @param prefixedString the string to be displayed, consisting of a prefix for field selection
- *        and the value to be displayed. 
+ * Sends the latency histograms as answer to the "lat?;" message, e.g. "lat:f1=0/3/12/1/0/0/0/0/0/0/0/0,f2=...,f3=...;":
+ * per field, how many values were drawn within 1 ms, 1 to 2 ms, 2 to 4 ms ... 512 to 1024 ms, and later,
+ * counted from parsing the ';' which ends the message containing the value, or the last byte of its binary frame,
+ * to the end of drawing it. The time the message waited in the receive buffer before is not included. See LatencyHistogram.
  */
-void determineFieldAndDisplayString(String prefixedString)
+void sendLatencyHistograms()
 {
-  // Serial.print("prefixedString: " + prefixedString + "\r\n");
-  if (prefixedString.startsWith(VELOCITY_FIELD_PREFIX)) 
-  {
-    velocityField.displayValue(prefixedString.substring(FIELD_PREFIX_LENGTH));
-  }
-  else if (prefixedString.startsWith(DIRECTION_STRING_FIELD_PREFIX))
+  bluetooth.print(F("lat:"));
+  for (uint8_t i = 0; i < sizeof(fieldsByNumber) / sizeof(fieldsByNumber[0]); i++)
   {
-    directionStringField.displayValue(prefixedString.substring(FIELD_PREFIX_LENGTH));
+    LatencyHistogram *latencyHistogram = fieldsByNumber[i]->getLatencyHistogram();
+    if (i > 0)
+    {
+      bluetooth.write(',');
+    }
+    bluetooth.write('f');
+    bluetooth.print(i + 1);
+    bluetooth.write('=');
+    for (uint8_t bucket = 0; bucket < LATENCY_HISTOGRAM_BUCKETS; bucket++)
+    {
+      if (bucket > 0)
+      {
+        bluetooth.write('/');
+      }
+      bluetooth.print(latencyHistogram->getCount(bucket));
+    }
   }
-  else if (prefixedString.startsWith(DIRECTION_BAR_FIELD_PREFIX))
+  bluetooth.write(';');
+}
+
+/**
+ * Sets all performance counters sent by sendStatistics() to zero and empties the latency histograms,
+ * as answer to the "stats:reset;" message.
+ */
+void resetStatistics()
+{
+  messageParser.resetCounters();
+  binaryFrameParser.resetCounters();
+  display.resetCounters();
+  for (uint8_t i = 0; i < sizeof(fieldsByNumber) / sizeof(fieldsByNumber[0]); i++)
   {
-    directionBarField.displayValue(prefixedString.substring(FIELD_PREFIX_LENGTH));
+    fieldsByNumber[i]->resetCounters();
   }
-//  else 
-//  {
-//    directionStringField.displayValue(prefixedString);
-//  }
+  receiveBufferFullCount = 0;
 }
 
 /**
@@ -200,8 +377,8 @@ void determineFieldAndDisplayString(String prefixedString)
  */
 void displayNoBluetoothConnection()
 {
-  velocityField.displayValue("No");
-  directionStringField.displayValue("Con");
+  velocityField.setValue("No", 2);
+  directionStringField.setValue("Con", 3);
 }
 
 /**
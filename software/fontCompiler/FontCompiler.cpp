@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+
+// Host tool which calculates data for a GFX font at build time and writes it as header file to stdout.
+// The font is compiled in, its header file and name are passed as FONT_HEADER and FONT_NAME defines.
+//
+// Usage: fontCompiler metrics               writes the font metrics header (FONT_NAME Metrics.h)
+//        fontCompiler pages <characters>    writes the page font header (FONT_NAME Pages.h) containing
+//                                           the glyphs of the given characters in display format
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#include <Arduino.h>
+#include <gfxfont.h>
+
+#include FONT_HEADER
+
+#define STRINGIFY(x) #x
+#define TOSTRING(x) STRINGIFY(x)
+
+unsigned long hostProgmemReads = 0;
+
+static const GFXfont *font = &FONT_NAME;
+
+static const char *fontName = TOSTRING(FONT_NAME);
+
+/**
+ * Returns the glyph of character c of the font.
+ */
+static const GFXglyph &getGlyph(uint16_t c)
+{
+  return font->glyph[c - font->first];
+}
+
+/**
+ * Writes the include guard macro name for a generated header, e.g. FREESANSBOLD24PT7B_METRICS_H.
+ */
+static void printIncludeGuard(const char *suffix)
+{
+  for (const char *c = fontName; *c; c++)
+  {
+    putchar(toupper(*c));
+  }
+  putchar('_');
+  for (const char *c = suffix; *c; c++)
+  {
+    putchar(toupper(*c));
+  }
+  printf("_H\n");
+}
+
+/**
+ * Writes the start of a generated header file, i.e. a comment and the include guard.
+ */
+static void printHeaderStart(const char *suffix)
+{
+  printf("// Generated by software/fontCompiler from %s.h, do not edit.\n\n", fontName);
+  printf("#ifndef ");
+  printIncludeGuard(suffix);
+  printf("#define ");
+  printIncludeGuard(suffix);
+  printf("\n");
+}
+
+/**
+ * Writes a byte array in PGM space.
+ */
+static void printByteArray(const char *name, const uint8_t *bytes, size_t length)
+{
+  printf("const uint8_t %s[] PROGMEM = {", name);
+  for (size_t i = 0; i < length; i++)
+  {
+    printf(i % 12 == 0 ? "\n    " : " ");
+    printf("0x%02X%s", bytes[i], i + 1 < length ? "," : "");
+  }
+  printf("};\n\n");
+}
+
+/**
+ * Calculates the position of the baseline of the font, relative to the top of the line (negative).
+ * The metrics are calculated the same way as the Font constructor does without metrics.
+ */
+static int8_t calculateYBaseline(int8_t *maxHeightAboveBaseline, int8_t *maxDescentBelowBaseline)
+{
+  *maxHeightAboveBaseline = 0;
+  *maxDescentBelowBaseline = 0;
+  for (uint16_t c = font->first; c <= font->last; c++)
+  {
+    const GFXglyph &glyph = getGlyph(c);
+    if (-glyph.yOffset > *maxHeightAboveBaseline)
+    {
+      *maxHeightAboveBaseline = -glyph.yOffset;
+    }
+    if (glyph.yOffset + glyph.height > *maxDescentBelowBaseline)
+    {
+      *maxDescentBelowBaseline = glyph.yOffset + glyph.height;
+    }
+  }
+  return -*maxHeightAboveBaseline - (font->yAdvance - *maxHeightAboveBaseline - *maxDescentBelowBaseline) / 2;
+}
+
+/**
+ * Writes the FontMetrics of the font.
+ */
+static void printMetrics()
+{
+  int8_t maxHeightAboveBaseline;
+  int8_t maxDescentBelowBaseline;
+  int8_t yBaseline = calculateYBaseline(&maxHeightAboveBaseline, &maxDescentBelowBaseline);
+  uint8_t xAdvances[256];
+  for (uint16_t c = font->first; c <= font->last; c++)
+  {
+    xAdvances[c - font->first] = getGlyph(c).xAdvance;
+  }
+
+  printHeaderStart("Metrics");
+  printf("#include \"Font.h\"\n\n");
+  char name[128];
+  snprintf(name, sizeof(name), "%sXAdvances", fontName);
+  printByteArray(name, xAdvances, font->last - font->first + 1);
+  printf("const FontMetrics %sMetrics PROGMEM = {%d, %d, %d, %s};\n\n", 
+      fontName, yBaseline, maxHeightAboveBaseline, maxDescentBelowBaseline, name);
+  printf("#endif\n");
+}
+
+/**
+ * Writes the PageFont of the font, containing the glyphs of the passed characters.
+ * Each glyph is transposed from the row-major GFX bitmap into column bytes, 
+ * shifted to the font baseline and stored page by page, only pages containing pixels of the glyph are stored.
+ * Pixels above the top of the line are dropped.
+ */
+static void printPages(const char *characters)
+{
+  int8_t maxHeightAboveBaseline;
+  int8_t maxDescentBelowBaseline;
+  int8_t yBaseline = calculateYBaseline(&maxHeightAboveBaseline, &maxDescentBelowBaseline);
+
+  static uint8_t data[65536];
+  size_t dataLength = 0;
+
+  printHeaderStart("Pages");
+  printf("#include \"Font.h\"\n\n");
+  printf("const PageGlyph %sPageGlyphs[] PROGMEM = {\n", fontName);
+  for (uint16_t c = font->first; c <= font->last; c++)
+  {
+    const GFXglyph &glyph = getGlyph(c);
+    int16_t yTop = glyph.yOffset - yBaseline;
+    int16_t yBottom = yTop + glyph.height - 1;
+    if (strchr(characters, c) == NULL || glyph.width == 0 || glyph.height == 0 || yBottom < 0)
+    {
+      printf("    %-16s// 0x%02X not contained\n", "{0, 0, 0},", c);
+      continue;
+    }
+    uint8_t firstPage = yTop < 0 ? 0 : yTop / 8;
+    uint8_t pageCount = yBottom / 8 - firstPage + 1;
+    size_t glyphLength = pageCount * glyph.width;
+    uint8_t *columns = data + dataLength;
+    memset(columns, 0, glyphLength);
+    for (uint8_t yInBitmap = 0; yInBitmap < glyph.height; yInBitmap++)
+    {
+      int16_t y = yTop + yInBitmap;
+      for (uint8_t xInBitmap = 0; xInBitmap < glyph.width; xInBitmap++)
+      {
+        uint16_t bit = yInBitmap * glyph.width + xInBitmap;
+        if (y >= 0 && (font->bitmap[glyph.bitmapOffset + bit / 8] & (0x80 >> (bit % 8))))
+        {
+          columns[(y / 8 - firstPage) * glyph.width + xInBitmap] |= 0x01 << (y % 8);
+        }
+      }
+    }
+    char entry[32];
+    snprintf(entry, sizeof(entry), "{%zu, %d, %d},", dataLength, firstPage, pageCount);
+    printf("    %-16s// 0x%02X '%c'\n", entry, c, c);
+    dataLength += glyphLength;
+  }
+  printf("};\n\n");
+
+  char name[128];
+  snprintf(name, sizeof(name), "%sPageData", fontName);
+  printByteArray(name, data, dataLength);
+  printf("const PageFont %sPageFont PROGMEM = {%s, %sPageGlyphs};\n\n", fontName, name, fontName);
+  printf("// Approx. %zu bytes\n\n", dataLength + (font->last - font->first + 1) * 4 + 4);
+  printf("#endif\n");
+}
+
+int main(int argc, char **argv)
+{
+  if (argc == 2 && !strcmp(argv[1], "metrics"))
+  {
+    printMetrics();
+    return 0;
+  }
+  if (argc == 3 && !strcmp(argv[1], "pages"))
+  {
+    printPages(argv[2]);
+    return 0;
+  }
+  fprintf(stderr, "usage: %s metrics | pages <characters>\n", argv[0]);
+  return 2;
+}
@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+#include <deque>
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <SoftwareSerial.h>
+#include <avr/sleep.h>
+
+#include "St7565Emulator.h"
+
+unsigned long hostProgmemReads = 0;
+
+SPIClass SPI;
+
+static unsigned long simulatedMicros = 0;
+
+static int analogValue = 620;
+
+static std::deque<char> serialReceiveQueue;
+
+static bool serialOverflow = false;
+
+static std::string serialOutput;
+
+HostSpiDataRegister SPDR;
+
+uint8_t SPSR = 0;
+
+uint8_t SREG = 0x80;
+
+static HostPortRegister portRegisters[] = {{0, 0}, {1, 0}, {PB, 0}, {PC, 0}, {PD, 0}};
+
+uint8_t digitalPinToPort(uint8_t pin)
+{
+  if (pin < 8)
+  {
+    return PD;
+  }
+  if (pin < 14)
+  {
+    return PB;
+  }
+  if (pin < 20)
+  {
+    return PC;
+  }
+  return NOT_A_PORT;
+}
+
+uint8_t digitalPinToBitMask(uint8_t pin)
+{
+  if (pin < 8)
+  {
+    return 1 << pin;
+  }
+  if (pin < 14)
+  {
+    return 1 << (pin - 8);
+  }
+  if (pin < 20)
+  {
+    return 1 << (pin - 14);
+  }
+  return 0;
+}
+
+HostPortRegister *portOutputRegister(uint8_t port)
+{
+  return &portRegisters[port];
+}
+
+void HostPortRegister::write(uint8_t newValue)
+{
+  uint8_t changed = value ^ newValue;
+  value = newValue;
+  for (uint8_t pin = 0; pin < 20; pin++)
+  {
+    if (digitalPinToPort(pin) == port && (changed & digitalPinToBitMask(pin)))
+    {
+      hostDisplayEmulator.pinWrite(pin, newValue & digitalPinToBitMask(pin));
+    }
+  }
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+  HostPortRegister *portRegister = portOutputRegister(digitalPinToPort(pin));
+  uint8_t bitMask = digitalPinToBitMask(pin);
+  if (value)
+  {
+    portRegister->value |= bitMask;
+  }
+  else
+  {
+    portRegister->value &= ~bitMask;
+  }
+  hostDisplayEmulator.pinWrite(pin, value);
+}
+
+int digitalRead(uint8_t pin)
+{
+  return LOW;
+}
+
+int analogRead(uint8_t pin)
+{
+  return analogValue;
+}
+
+void delay(unsigned long ms)
+{
+  simulatedMicros += ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  simulatedMicros += us;
+}
+
+unsigned long millis()
+{
+  return simulatedMicros / 1000;
+}
+
+unsigned long micros()
+{
+  return simulatedMicros;
+}
+
+void yield()
+{
+}
+
+void hostAdvanceMicros(unsigned long us)
+{
+  simulatedMicros += us;
+}
+
+void sleep_cpu()
+{
+  // the millis() timer overflows every 1024 us
+  simulatedMicros += 1024 - simulatedMicros % 1024;
+}
+
+void hostSetAnalogValue(int value)
+{
+  analogValue = value;
+}
+
+void SPIClass::begin()
+{
+}
+
+void SPIClass::end()
+{
+}
+
+void SPIClass::setBitOrder(uint8_t bitOrder)
+{
+}
+
+void SPIClass::setDataMode(uint8_t dataMode)
+{
+}
+
+void SPIClass::setClockDivider(uint8_t clockDivider)
+{
+  this->clockDivider = clockDivider;
+}
+
+uint8_t SPIClass::getClockDivision()
+{
+  static const uint8_t divisions[] = {4, 16, 64, 128, 2, 8, 32, 64};
+  return divisions[clockDivider & 0x07];
+}
+
+uint8_t SPIClass::transfer(uint8_t data)
+{
+  unsigned long microsPerByte = 8UL * getClockDivision() * 1000000UL / F_CPU;
+  simulatedMicros += microsPerByte;
+  hostDisplayEmulator.spiTransfer(data, microsPerByte);
+  return 0;
+}
+
+HostSpiDataRegister &HostSpiDataRegister::operator=(uint8_t data)
+{
+  // the sketch waits for SPIF before the next write, so the transfer time is counted like that of SPI.transfer()
+  unsigned long microsPerByte = 8UL * SPI.getClockDivision() * 1000000UL / F_CPU;
+  simulatedMicros += microsPerByte;
+  hostDisplayEmulator.spiTransfer(data, microsPerByte);
+  SPSR |= _BV(SPIF);
+  return *this;
+}
+
+// appends a string from program memory to the written bytes, reading it via pgm_read_byte like the Arduino core does
+static size_t hostPrintProgmem(const __FlashStringHelper *str)
+{
+  const char *progmemString = reinterpret_cast<const char *>(str);
+  size_t length = 0;
+  char c;
+  while ((c = pgm_read_byte(progmemString + length)) != '\0')
+  {
+    serialOutput += c;
+    length++;
+  }
+  return length;
+}
+
+HardwareSerial Serial;
+
+void HardwareSerial::begin(unsigned long speed)
+{
+}
+
+int HardwareSerial::available()
+{
+  return serialReceiveQueue.size();
+}
+
+int HardwareSerial::read()
+{
+  if (serialReceiveQueue.empty())
+  {
+    return -1;
+  }
+  char result = serialReceiveQueue.front();
+  serialReceiveQueue.pop_front();
+  return (uint8_t) result;
+}
+
+size_t HardwareSerial::write(uint8_t byte)
+{
+  serialOutput += (char) byte;
+  return 1;
+}
+
+size_t HardwareSerial::write(const char *str)
+{
+  serialOutput += str;
+  return strlen(str);
+}
+
+size_t HardwareSerial::print(const __FlashStringHelper *str)
+{
+  return hostPrintProgmem(str);
+}
+
+size_t HardwareSerial::print(unsigned long value)
+{
+  return write(std::to_string(value).c_str());
+}
+
+SoftwareSerial::SoftwareSerial(uint8_t receivePin, uint8_t transmitPin)
+{
+}
+
+void SoftwareSerial::begin(long speed)
+{
+}
+
+int SoftwareSerial::available()
+{
+  return serialReceiveQueue.size();
+}
+
+int SoftwareSerial::read()
+{
+  if (serialReceiveQueue.empty())
+  {
+    return -1;
+  }
+  char result = serialReceiveQueue.front();
+  serialReceiveQueue.pop_front();
+  return (uint8_t) result;
+}
+
+bool SoftwareSerial::overflow()
+{
+  bool result = serialOverflow;
+  serialOverflow = false;
+  return result;
+}
+
+size_t SoftwareSerial::write(uint8_t byte)
+{
+  serialOutput += (char) byte;
+  return 1;
+}
+
+size_t SoftwareSerial::write(const char *str)
+{
+  serialOutput += str;
+  return strlen(str);
+}
+
+size_t SoftwareSerial::print(const __FlashStringHelper *str)
+{
+  return hostPrintProgmem(str);
+}
+
+size_t SoftwareSerial::print(unsigned long value)
+{
+  return write(std::to_string(value).c_str());
+}
+
+void hostSerialInput(const char *bytes)
+{
+  hostSerialInput(bytes, strlen(bytes));
+}
+
+void hostSerialInput(const char *bytes, size_t length)
+{
+  for (size_t i = 0; i < length; i++)
+  {
+    if (serialReceiveQueue.size() >= SERIAL_RX_BUFFER_SIZE - 1)
+    {
+      serialOverflow = true;
+    }
+    else
+    {
+      serialReceiveQueue.push_back(*bytes);
+    }
+    bytes++;
+  }
+}
+
+String hostSerialOutput()
+{
+  String result(serialOutput);
+  serialOutput.clear();
+  return result;
+}
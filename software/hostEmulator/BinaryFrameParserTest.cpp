@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+
+// Tests of the BinaryFrameParser with corrupted, lost and duplicate frames, running on the host.
+//
+// Usage: bluetoothDisplay240Test
+//
+// Prints each failed check and exits with status 1 if a check failed.
+
+#include <stdio.h>
+#include <string.h>
+
+#include <Arduino.h>
+#include <util/crc16.h>
+
+#include "BinaryFrameParser.h"
+#include "FieldConfiguration.h"
+
+// A field which remembers the last value set, instead of drawing it
+class RecordingField : public FieldConfiguration
+{
+  public:
+  char value[BINARY_FRAME_MAX_TEXT_LENGTH + 1]; // the last value set, zero terminated
+  uint8_t setCount = 0;                         // how many values were set
+
+  void setValue(const char *value, uint8_t length)
+  {
+    memcpy(this->value, value, length);
+    this->value[length] = '\0';
+    setCount++;
+  }
+
+  void renderPage(uint8_t yInBytes)
+  {
+  }
+
+  void finishRender()
+  {
+  }
+};
+
+static RecordingField field1;
+
+static RecordingField field2;
+
+static FieldConfiguration *const fieldsByNumber[] = {&field1, &field2};
+
+static int failedCheckCount = 0;
+
+#define CHECK(condition) check(condition, #condition, __LINE__)
+
+/**
+ * Counts a failed check and prints its description.
+ */
+static void check(bool condition, const char *description, int line)
+{
+  if (!condition)
+  {
+    printf("line %d: check failed: %s\n", line, description);
+    failedCheckCount++;
+  }
+}
+
+/**
+ * Encodes a binary frame with the given field number and value with one decimal place, see BinaryFrameParser.h.
+ *
+ * @return the length of the frame.
+ */
+static uint8_t encodeBinaryFrame(uint8_t fieldNumber, int16_t value, uint8_t sequenceNumber, uint8_t *frame)
+{
+  uint16_t encodedValue = (uint16_t) ((value << 1) ^ (value >> 15));
+  uint8_t length = 0;
+  frame[length++] = BINARY_FRAME_SYNC;
+  frame[length++] = fieldNumber | 0x10;
+  frame[length++] = sequenceNumber;
+  do
+  {
+    frame[length] = encodedValue & 0x7F;
+    encodedValue >>= 7;
+    if (encodedValue != 0)
+    {
+      frame[length] |= 0x80;
+    }
+    length++;
+  } while (encodedValue != 0);
+  uint8_t crc = 0;
+  for (uint8_t i = 1; i < length; i++)
+  {
+    crc = _crc8_ccitt_update(crc, frame[i]);
+  }
+  frame[length++] = crc;
+  return length;
+}
+
+/**
+ * Passes bytes to the parser.
+ *
+ * @return the last result of the parser other than MESSAGE_NONE, or MESSAGE_NONE.
+ */
+static uint8_t parse(BinaryFrameParser &parser, const uint8_t *bytes, uint8_t length)
+{
+  uint8_t result = MESSAGE_NONE;
+  for (uint8_t i = 0; i < length; i++)
+  {
+    uint8_t byteResult = parser.parse(bytes[i]);
+    if (byteResult != MESSAGE_NONE)
+    {
+      result = byteResult;
+    }
+  }
+  return result;
+}
+
+/**
+ * Encodes a frame and passes it to the parser.
+ *
+ * @return the result of the parser for the last byte of the frame.
+ */
+static uint8_t parseFrame(BinaryFrameParser &parser, uint8_t fieldNumber, int16_t value, uint8_t sequenceNumber)
+{
+  uint8_t frame[BINARY_FRAME_MAX_LENGTH];
+  uint8_t length = encodeBinaryFrame(fieldNumber, value, sequenceNumber, frame);
+  return parse(parser, frame, length);
+}
+
+static void testValidFrames()
+{
+  BinaryFrameParser parser(fieldsByNumber, 2);
+  CHECK(parseFrame(parser, 1, 123, 0) == MESSAGE_FIELD_VALUE);
+  CHECK(strcmp(field1.value, "12.3") == 0);
+  CHECK(parseFrame(parser, 2, -3276, 1) == MESSAGE_FIELD_VALUE);
+  CHECK(strcmp(field2.value, "-327.6") == 0);
+  CHECK(parseFrame(parser, 2, INT16_MIN, 2) == MESSAGE_FIELD_VALUE);
+  CHECK(strcmp(field2.value, "-3276.8") == 0);
+  CHECK(parser.getCorruptedFrameCount() == 0);
+  CHECK(parser.getLostFrameCount() == 0);
+}
+
+static void testWrongCrc()
+{
+  BinaryFrameParser parser(fieldsByNumber, 2);
+  uint8_t frame[BINARY_FRAME_MAX_LENGTH];
+  parseFrame(parser, 1, 10, 0);
+  uint8_t length = encodeBinaryFrame(1, 20, 1, frame);
+  frame[length - 1] ^= 0x01;
+  CHECK(parse(parser, frame, length) == MESSAGE_NONE);
+  CHECK(strcmp(field1.value, "1.0") == 0);
+  parseFrame(parser, 1, 30, 2);
+  CHECK(strcmp(field1.value, "3.0") == 0);
+  CHECK(parser.getCorruptedFrameCount() == 1);
+  // the sequence number of the corrupted frame is missing
+  CHECK(parser.getLostFrameCount() == 1);
+}
+
+static void testTooLongValue()
+{
+  BinaryFrameParser parser(fieldsByNumber, 2);
+  // a third value byte above 0x03 would exceed 16 bits
+  uint8_t header = 0x01;
+  uint8_t sequenceNumber = 0;
+  uint8_t value[] = {0xFF, 0xFF, 0x04};
+  uint8_t crc = _crc8_ccitt_update(_crc8_ccitt_update(0, header), sequenceNumber);
+  for (uint8_t i = 0; i < sizeof(value); i++)
+  {
+    crc = _crc8_ccitt_update(crc, value[i]);
+  }
+  uint8_t frame[] = {BINARY_FRAME_SYNC, header, sequenceNumber, value[0], value[1], value[2], crc};
+  uint8_t setCount = field1.setCount;
+  parse(parser, frame, sizeof(frame));
+  CHECK(field1.setCount == setCount);
+  CHECK(parser.getCorruptedFrameCount() == 1);
+}
+
+static void testMissingCrcByte()
+{
+  BinaryFrameParser parser(fieldsByNumber, 2);
+  uint8_t frames[2 * BINARY_FRAME_MAX_LENGTH];
+  parseFrame(parser, 2, 10, 0);
+  // the CRC byte of the first frame is lost, so the sync byte of the next frame is taken as CRC
+  uint8_t length = encodeBinaryFrame(2, 20, 1, frames) - 1;
+  CHECK(frames[length] != BINARY_FRAME_SYNC);
+  length += encodeBinaryFrame(2, 30, 2, frames + length);
+  CHECK(parse(parser, frames, length) == MESSAGE_FIELD_VALUE);
+  // the next frame is found again among the bytes of the corrupted frame
+  CHECK(strcmp(field2.value, "3.0") == 0);
+  CHECK(parser.getCorruptedFrameCount() == 1);
+  CHECK(parser.getLostFrameCount() == 1);
+}
+
+static void testLostFrames()
+{
+  BinaryFrameParser parser(fieldsByNumber, 2);
+  parseFrame(parser, 1, 10, 254);
+  parseFrame(parser, 1, 20, 2);
+  CHECK(strcmp(field1.value, "2.0") == 0);
+  // 255, 0 and 1 are missing
+  CHECK(parser.getLostFrameCount() == 3);
+  CHECK(parser.getCorruptedFrameCount() == 0);
+}
+
+static void testDuplicateFrames()
+{
+  BinaryFrameParser parser(fieldsByNumber, 2);
+  parseFrame(parser, 1, 10, 5);
+  CHECK(parseFrame(parser, 1, 10, 5) == MESSAGE_FIELD_VALUE);
+  parseFrame(parser, 1, 20, 6);
+  CHECK(strcmp(field1.value, "2.0") == 0);
+  CHECK(parser.getLostFrameCount() == 0);
+  CHECK(parser.getCorruptedFrameCount() == 0);
+}
+
+static void testAsciiModeRequest()
+{
+  BinaryFrameParser parser(fieldsByNumber, 2);
+  CHECK(parseFrame(parser, 0, 0, 0) == MESSAGE_ASCII_MODE_REQUEST);
+}
+
+static void testAsciiFallback()
+{
+  BinaryFrameParser parser(fieldsByNumber, 2);
+  parseFrame(parser, 1, 10, 0);
+  const char *messages = "f1:12.3;f2:045;f1:12.4;f2:046;f1:12.5;";
+  uint8_t result = MESSAGE_NONE;
+  uint8_t i = 0;
+  while (result == MESSAGE_NONE && messages[i] != '\0')
+  {
+    result = parser.parse(messages[i++]);
+  }
+  CHECK(result == MESSAGE_ASCII_MODE_REQUEST);
+  CHECK(i == BINARY_FRAME_MAX_INVALID_BYTES);
+  // a valid frame restarts the count
+  parser.reset();
+  parse(parser, (const uint8_t *) messages, BINARY_FRAME_MAX_INVALID_BYTES - 1);
+  CHECK(parseFrame(parser, 1, 10, 1) == MESSAGE_FIELD_VALUE);
+  CHECK(parse(parser, (const uint8_t *) messages, BINARY_FRAME_MAX_INVALID_BYTES - 1) == MESSAGE_NONE);
+}
+
+int main(int argc, char **argv)
+{
+  testValidFrames();
+  testWrongCrc();
+  testTooLongValue();
+  testMissingCrcByte();
+  testLostFrames();
+  testDuplicateFrames();
+  testAsciiModeRequest();
+  testAsciiFallback();
+  if (failedCheckCount > 0)
+  {
+    printf("%d checks failed\n", failedCheckCount);
+    return 1;
+  }
+  printf("all checks passed\n");
+  return 0;
+}
@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+
+// Microbenchmarks of the drawing and parsing code of the sketch, running on the host against the display controller emulator.
+//
+// Usage: bluetoothDisplay240Benchmark [minimumTimeInMs]
+//
+// Each benchmark repeats one operation until at least minimumTimeInMs (default 200) of wall time have passed,
+// and prints per operation: the wall time on the host, the bytes sent to the display via SPI,
+// the pgm_read_* calls and the heap allocations (calls of malloc, calloc and realloc, including those by operator new).
+// The wall time depends on the host; the other columns are what the operation costs on the device.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <new>
+
+#include <Arduino.h>
+#include <util/crc16.h>
+
+#include "St7565Emulator.h"
+#include "DogDisplay.h"
+#include "Font.h"
+#include "StringDisplay.h"
+#include "FieldConfiguration.h"
+#include "DisplayCompositor.h"
+#include "MessageParser.h"
+#include "BinaryFrameParser.h"
+#include "FreeSansBold24pt7b.h"
+#include "FreeSansBold24pt7bMetrics.h"
+#include "FreeSansBold24pt7bPages.h"
+
+void setup();
+
+extern DogDisplay display;
+extern Font valueFont;
+extern StringFieldConfiguration velocityField;
+extern BarFieldConfiguration directionBarField;
+extern DisplayCompositor compositor;
+extern MessageParser messageParser;
+extern BinaryFrameParser binaryFrameParser;
+
+static unsigned long heapAllocations = 0;
+
+// the Makefile links the benchmark with --wrap for malloc, calloc and realloc,
+// so calls of them from the sketch and the stubs come here, and __real_* are the functions of the C library
+extern "C" void *__real_malloc(size_t size);
+extern "C" void *__real_calloc(size_t count, size_t size);
+extern "C" void *__real_realloc(void *pointer, size_t size);
+
+extern "C" void *__wrap_malloc(size_t size)
+{
+  heapAllocations++;
+  return __real_malloc(size);
+}
+
+extern "C" void *__wrap_calloc(size_t count, size_t size)
+{
+  heapAllocations++;
+  return __real_calloc(count, size);
+}
+
+extern "C" void *__wrap_realloc(void *pointer, size_t size)
+{
+  heapAllocations++;
+  return __real_realloc(pointer, size);
+}
+
+// counted by __wrap_malloc
+void *operator new(size_t size)
+{
+  void *result = malloc(size);
+  if (result == NULL)
+  {
+    throw std::bad_alloc();
+  }
+  return result;
+}
+
+void *operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+  free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+  free(pointer);
+}
+
+void operator delete(void *pointer, size_t size) noexcept
+{
+  free(pointer);
+}
+
+void operator delete[](void *pointer, size_t size) noexcept
+{
+  free(pointer);
+}
+
+// keeps the compiler from removing the benchmarked calls
+static volatile unsigned long sink;
+
+static unsigned long minimumTimeInMs = 200;
+
+/**
+ * Runs operation repeatedly, with an increasing number of iterations until minimumTimeInMs have passed,
+ * and prints the averages per operation.
+ *
+ * @param name the name of the benchmark.
+ * @param operation the operation to measure; gets the number of the iteration, e.g. to alternate between values.
+ */
+template <typename Operation>
+static void benchmark(const char *name, Operation operation)
+{
+  unsigned long iterations = 1;
+  while (true)
+  {
+    display.flush();
+    hostDisplayEmulator.resetCounters();
+    unsigned long allocationsAtStart = heapAllocations;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < iterations; i++)
+    {
+      operation(i);
+    }
+    display.flush();
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    double nanos = std::chrono::duration<double, std::nano>(end - start).count();
+    if (nanos >= minimumTimeInMs * 1e6 || iterations >= 1UL << 30)
+    {
+      St7565Counters counters = hostDisplayEmulator.getCounters();
+      printf("%-40s %10lu %12.1f %10.1f %10.1f %8.2f\n",
+          name,
+          iterations,
+          nanos / iterations,
+          (double) counters.bytes / iterations,
+          (double) counters.progmemReads / iterations,
+          (double) (heapAllocations - allocationsAtStart) / iterations);
+      return;
+    }
+    iterations *= 2;
+  }
+}
+
+/**
+ * Encodes a binary frame with the given field number and value without decimal places, see BinaryFrameParser.h.
+ *
+ * @return the length of the frame.
+ */
+static uint8_t encodeBinaryFrame(uint8_t fieldNumber, int16_t value, uint8_t sequenceNumber, uint8_t *frame)
+{
+  uint16_t encodedValue = (uint16_t) ((value << 1) ^ (value >> 15));
+  uint8_t length = 0;
+  frame[length++] = BINARY_FRAME_SYNC;
+  frame[length++] = fieldNumber;
+  frame[length++] = sequenceNumber;
+  do
+  {
+    frame[length] = encodedValue & 0x7F;
+    encodedValue >>= 7;
+    if (encodedValue != 0)
+    {
+      frame[length] |= 0x80;
+    }
+    length++;
+  } while (encodedValue != 0);
+  uint8_t crc = 0;
+  for (uint8_t i = 1; i < length; i++)
+  {
+    crc = _crc8_ccitt_update(crc, frame[i]);
+  }
+  frame[length++] = crc;
+  return length;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 2 || (argc == 2 && atol(argv[1]) <= 0))
+  {
+    fprintf(stderr, "usage: %s [minimumTimeInMs]\n", argv[0]);
+    return 2;
+  }
+  if (argc == 2)
+  {
+    minimumTimeInMs = atol(argv[1]);
+  }
+
+  // pins as used in setup() of the sketch
+  hostDisplayEmulator.connect(10, 9, MOSI, SCK);
+  setup();
+  // every render is measured, not only one per frame interval
+  compositor.minFrameIntervalInMs = 0;
+
+  printf("%-40s %10s %12s %10s %10s %8s\n", "benchmark", "iterations", "ns/op", "spi/op", "progmem/op", "alloc/op");
+
+  benchmark("Font::Font", [](unsigned long i) {
+    Font font(&FreeSansBold24pt7b, &FreeSansBold24pt7bMetrics, &FreeSansBold24pt7bPageFont);
+    sink = font.getYAdvance();
+  });
+
+  benchmark("Font::getGlyph", [](unsigned long i) {
+    sink = valueFont.getGlyph('0' + i % 10).width;
+  });
+
+  benchmark("StringDisplay::StringDisplay 12.3", [](unsigned long i) {
+    StringDisplay stringDisplay(&valueFont, "12.3", 4);
+    sink = stringDisplay.getWidth();
+  });
+
+  benchmark("StringDisplay::getBitAt 12.3, all pixels", [](unsigned long i) {
+    static StringDisplay stringDisplay(&valueFont, "12.3", 4);
+    unsigned long setBits = 0;
+    for (int16_t y = 0; y < 6 * 8; y++)
+    {
+      for (int16_t x = 0; x < (int16_t) stringDisplay.getWidth(); x++)
+      {
+        setBits += stringDisplay.getBitAt(x, y);
+      }
+    }
+    sink = setBits;
+  });
+
+  benchmark("StringDisplay::nextColumn 12.3, all pages", [](unsigned long i) {
+    static StringDisplay stringDisplay(&valueFont, "12.3", 4);
+    unsigned long columns = 0;
+    for (uint8_t yInBytes = 0; yInBytes < 6; yInBytes++)
+    {
+      stringDisplay.startPage(yInBytes);
+      for (uint16_t x = 0; x < stringDisplay.getWidth(); x++)
+      {
+        columns += stringDisplay.nextColumn();
+      }
+    }
+    sink = columns;
+  });
+
+  benchmark("string field 12.3 <-> 18.8", [](unsigned long i) {
+    velocityField.setValue(i % 2 ? "18.8" : "12.3", 4);
+    compositor.render();
+  });
+
+  benchmark("string field 12.3 <-> 12.4", [](unsigned long i) {
+    velocityField.setValue(i % 2 ? "12.4" : "12.3", 4);
+    compositor.render();
+  });
+
+  benchmark("bar field -12 <-> 40", [](unsigned long i) {
+    directionBarField.setValue(i % 2 ? "40" : "-12", i % 2 ? 2 : 3);
+    compositor.render();
+  });
+
+  benchmark("bar field -12 <-> -10", [](unsigned long i) {
+    directionBarField.setValue(i % 2 ? "-10" : "-12", 3);
+    compositor.render();
+  });
+
+  benchmark("DogDisplay::drawBatterySymbol changed", [](unsigned long i) {
+    display.drawBatterySymbol(230, 5, i % 2 ? 0 : 255);
+  });
+
+  benchmark("DogDisplay::drawBatterySymbol unchanged", [](unsigned long i) {
+    display.drawBatterySymbol(230, 5, 255);
+  });
+
+  benchmark("MessageParser f1:12.3;f2:045;f3:-12;", [](unsigned long i) {
+    static const char message[] = "f1:12.3;f2:045;f3:-12;";
+    for (uint8_t j = 0; j < sizeof(message) - 1; j++)
+    {
+      sink = messageParser.parse(message[j]);
+    }
+  });
+
+  benchmark("BinaryFrameParser 3 frames", [](unsigned long i) {
+    static uint8_t frames[3 * BINARY_FRAME_MAX_LENGTH];
+    static uint8_t length = 0;
+    if (length == 0)
+    {
+      length += encodeBinaryFrame(1, 123, 0, frames + length);
+      length += encodeBinaryFrame(2, 45, 1, frames + length);
+      length += encodeBinaryFrame(3, -12, 2, frames + length);
+    }
+    // the sequence numbers do not continue, so from the second iteration on the parser counts lost frames
+    for (uint8_t j = 0; j < length; j++)
+    {
+      sink = binaryFrameParser.parse(frames[j]);
+    }
+  });
+
+  return 0;
+}
@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+
+// Runs the sketch on the host against the display controller emulator.
+//
+// Usage: bluetoothDisplay240Emulator [-o image.pbm] [-a analogValue] [-i intervalInMs] [-p] [-b] [message ...]
+//
+// Each message (e.g. "f1:12.3;") is fed to the bluetooth serial, then loop() runs until the next message is due.
+// Between its passes, loop() sleeps until the next interrupt, i.e. the simulated time advances to the next millis() tick.
+// Several messages in one argument (e.g. "f1:12.3;f1:12.4;") arrive together, so only the last value of each field is drawn;
+// the values which were replaced before being drawn are printed at the end.
+// -i sets the simulated time between two messages (default 100 ms). With a short interval, the frame rate limit
+// and the load shedding of the DisplayCompositor defer fields, which are drawn by a later pass of loop().
+// For setup and each message, the display traffic is printed as one line,
+// including the data bytes which were not sent because the display shadow found them unchanged.
+// -o writes the final display content as PBM image, -p prints it as ASCII art,
+// -a sets the value returned by analogRead (i.e. the battery voltage reading).
+// -b switches the sketch to binary frames by the "bin;" handshake and sends each message encoded as binary frames,
+// which must render the same display content as the ASCII messages. Values must be numbers for this.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include <Arduino.h>
+#include <SoftwareSerial.h>
+#include <util/crc16.h>
+
+#include "St7565Emulator.h"
+#include "DogDisplay.h"
+#include "BinaryFrameParser.h"
+#include "FieldConfiguration.h"
+
+void setup();
+void loop();
+
+extern DogDisplay display;
+
+extern BinaryFrameParser binaryFrameParser;
+
+extern uint16_t receiveBufferFullCount;
+
+extern StringFieldConfiguration velocityField;
+extern StringFieldConfiguration directionStringField;
+extern BarFieldConfiguration directionBarField;
+
+static uint32_t skippedBytesAtReset = 0;
+
+static const unsigned long DEFAULT_MESSAGE_INTERVAL_IN_MS = 100;
+
+static const char *DEFAULT_MESSAGES[] = {"f1:12.3;", "f1:12.4;", "f2:045;", "f2:046;", "f3:-12;", "f3:-10;", "f3:40;", "f1:8.7;"};
+
+/**
+ * Encodes ASCII messages (e.g. "f1:12.3;f2:045;") as binary frames, see BinaryFrameParser.h.
+ *
+ * @return false if a message is malformed or its value cannot be sent in a binary frame.
+ */
+static bool encodeBinaryFrames(const char *messages, std::string &frames)
+{
+  static uint8_t sequenceNumber = 0;
+  while (*messages)
+  {
+    const char *end = strchr(messages, ';');
+    if (end == NULL || messages[0] != 'f' || messages[1] < '1' || messages[1] > '9' || messages[2] != ':')
+    {
+      return false;
+    }
+    const char *value = messages + 3;
+    bool negative = (*value == '-');
+    if (negative)
+    {
+      value++;
+    }
+    long fixedPointValue = 0;
+    int integerDigits = 0;
+    int decimalPlaces = -1;
+    for (; value < end; value++)
+    {
+      if (*value == '.' && decimalPlaces < 0)
+      {
+        decimalPlaces = 0;
+      }
+      else if (*value >= '0' && *value <= '9')
+      {
+        fixedPointValue = fixedPointValue * 10 + (*value - '0');
+        if (decimalPlaces < 0)
+        {
+          integerDigits++;
+        }
+        else
+        {
+          decimalPlaces++;
+        }
+      }
+      else
+      {
+        return false;
+      }
+    }
+    decimalPlaces = decimalPlaces < 0 ? 0 : decimalPlaces;
+    integerDigits = integerDigits < 1 ? 1 : integerDigits;
+    if (negative)
+    {
+      fixedPointValue = -fixedPointValue;
+    }
+    if (decimalPlaces > 3 || integerDigits > 4 || fixedPointValue < INT16_MIN || fixedPointValue > INT16_MAX)
+    {
+      return false;
+    }
+
+    std::string frame;
+    frame += (char) ((messages[1] - '0') | (decimalPlaces << 4) | ((integerDigits - 1) << 6));
+    frame += (char) sequenceNumber++;
+    uint16_t zigzag = (uint16_t) ((fixedPointValue << 1) ^ (fixedPointValue >> 15));
+    do
+    {
+      uint8_t varintByte = zigzag & 0x7F;
+      zigzag >>= 7;
+      frame += (char) (zigzag ? varintByte | 0x80 : varintByte);
+    } while (zigzag);
+    uint8_t crc = 0;
+    for (char c : frame)
+    {
+      crc = _crc8_ccitt_update(crc, c);
+    }
+    frames += (char) BINARY_FRAME_SYNC;
+    frames += frame;
+    frames += (char) crc;
+    messages = end + 1;
+  }
+  return true;
+}
+
+/**
+ * Runs loop() for the given simulated time, at least once.
+ */
+static void runLoopFor(unsigned long ms)
+{
+  unsigned long end = micros() + ms * 1000;
+  do
+  {
+    loop();
+  } while ((long) (micros() - end) < 0);
+}
+
+static void printCountersHeader()
+{
+  printf("%-16s %8s %8s %8s %9s %8s %8s %8s %9s %8s\n",
+      "operation", "bytes", "data", "command", "position", "cs", "cd", "spi_us", "progmem", "skipped");
+}
+
+static void printCounters(const char *operation)
+{
+  display.flush();
+  St7565Counters counters = hostDisplayEmulator.getCounters();
+  if (display.getSkippedByteCount() < skippedBytesAtReset)
+  {
+    // the counters were reset by a "stats:reset;" message
+    skippedBytesAtReset = 0;
+  }
+  uint32_t skippedBytes = display.getSkippedByteCount() - skippedBytesAtReset;
+  skippedBytesAtReset = display.getSkippedByteCount();
+  printf("%-16s %8lu %8lu %8lu %9lu %8lu %8lu %8lu %9lu %8lu\n",
+      operation,
+      counters.bytes,
+      counters.dataBytes,
+      counters.commandBytes,
+      counters.positionCalls,
+      counters.chipSelects,
+      counters.cdToggles,
+      counters.spiMicros,
+      counters.progmemReads,
+      (unsigned long) skippedBytes);
+  hostDisplayEmulator.resetCounters();
+}
+
+int main(int argc, char **argv)
+{
+  const char *pbmFileName = NULL;
+  bool printDisplay = false;
+  bool binaryFrames = false;
+  unsigned long messageIntervalInMs = DEFAULT_MESSAGE_INTERVAL_IN_MS;
+  int firstMessage = 1;
+  for (; firstMessage < argc && argv[firstMessage][0] == '-'; firstMessage++)
+  {
+    if (!strcmp(argv[firstMessage], "-o") && firstMessage + 1 < argc)
+    {
+      pbmFileName = argv[++firstMessage];
+    }
+    else if (!strcmp(argv[firstMessage], "-a") && firstMessage + 1 < argc)
+    {
+      hostSetAnalogValue(atoi(argv[++firstMessage]));
+    }
+    else if (!strcmp(argv[firstMessage], "-i") && firstMessage + 1 < argc)
+    {
+      messageIntervalInMs = strtoul(argv[++firstMessage], NULL, 10);
+    }
+    else if (!strcmp(argv[firstMessage], "-p"))
+    {
+      printDisplay = true;
+    }
+    else if (!strcmp(argv[firstMessage], "-b"))
+    {
+      binaryFrames = true;
+    }
+    else
+    {
+      fprintf(stderr, "usage: %s [-o image.pbm] [-a analogValue] [-i intervalInMs] [-p] [-b] [message ...]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  // pins as used in setup() of the sketch
+  hostDisplayEmulator.connect(10, 9, MOSI, SCK);
+
+  printCountersHeader();
+  setup();
+  hostSerialOutput();
+  printCounters("setup");
+
+  loop();
+  printCounters("idle loop");
+
+  if (binaryFrames)
+  {
+    hostSerialInput(BINARY_MODE_REQUEST ";");
+    loop();
+    String answer = hostSerialOutput();
+    if (strcmp(answer.c_str(), "bin:ok;"))
+    {
+      fprintf(stderr, "binary mode request was answered with \"%s\"\n", answer.c_str());
+      return 1;
+    }
+    printCounters("bin;");
+  }
+
+  const char **messages = DEFAULT_MESSAGES;
+  int messageCount = sizeof(DEFAULT_MESSAGES) / sizeof(DEFAULT_MESSAGES[0]);
+  if (firstMessage < argc)
+  {
+    messages = (const char **) (argv + firstMessage);
+    messageCount = argc - firstMessage;
+  }
+  for (int i = 0; i < messageCount; i++)
+  {
+    if (binaryFrames)
+    {
+      std::string frames;
+      if (!encodeBinaryFrames(messages[i], frames))
+      {
+        fprintf(stderr, "cannot encode %s as binary frames\n", messages[i]);
+        return 2;
+      }
+      hostSerialInput(frames.data(), frames.size());
+    }
+    else
+    {
+      hostSerialInput(messages[i]);
+    }
+    runLoopFor(messageIntervalInMs);
+    printCounters(messages[i]);
+    String answer = hostSerialOutput();
+    if (answer.length() > 0)
+    {
+      printf("answer: %s\n", answer.c_str());
+    }
+  }
+
+  runLoopFor(1000);
+  printCounters("after 1 s");
+
+  if (binaryFrames)
+  {
+    printf("binary frames: %u corrupted, %u lost\n", binaryFrameParser.getCorruptedFrameCount(), binaryFrameParser.getLostFrameCount());
+  }
+  printf("dropped values: f1 %u, f2 %u, f3 %u\n",
+      velocityField.getDroppedValueCount(),
+      directionStringField.getDroppedValueCount(),
+      directionBarField.getDroppedValueCount());
+  printf("receive buffer full events: %u\n", receiveBufferFullCount);
+  if (printDisplay)
+  {
+    hostDisplayEmulator.print(stdout);
+  }
+  if (pbmFileName != NULL && !hostDisplayEmulator.writePbm(pbmFileName))
+  {
+    fprintf(stderr, "could not write %s\n", pbmFileName);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+
+// Compiles the sketch for the host.
+// The Arduino IDE generates the function prototypes of a sketch automatically, so we have to declare them here.
+
+#include <Arduino.h>
+
+void setup();
+void loop();
+void receiveBluetooth();
+void sendStatistics();
+void resetStatistics();
+void sendLatencyHistograms();
+void sleepUntilInterrupt();
+void displayNoBluetoothConnection();
+uint8_t batteryChargingState();
+
+#include "../bluetoothDisplay240/bluetoothDisplay240.ino"
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+#include "St7565Emulator.h"
+
+#include <avr/pgmspace.h>
+
+St7565Emulator hostDisplayEmulator;
+
+void St7565Emulator::connect(uint8_t csPin, uint8_t cdPin, uint8_t siPin, uint8_t clkPin)
+{
+  this->csPin = csPin;
+  this->cdPin = cdPin;
+  this->siPin = siPin;
+  this->clkPin = clkPin;
+}
+
+void St7565Emulator::pinWrite(uint8_t pin, uint8_t value)
+{
+  value = value ? 1 : 0;
+  if (pin == csPin)
+  {
+    if (csLevel && !value)
+    {
+      counters.chipSelects++;
+      shiftedBits = 0;
+    }
+    csLevel = value;
+  }
+  else if (pin == cdPin)
+  {
+    if (cdLevel != value)
+    {
+      counters.cdToggles++;
+    }
+    cdLevel = value;
+  }
+  else if (pin == siPin)
+  {
+    siLevel = value;
+  }
+  else if (pin == clkPin)
+  {
+    // mode 3: data is sampled on the rising clock edge
+    if (!clkLevel && value && !csLevel)
+    {
+      shiftRegister = (shiftRegister << 1) | siLevel;
+      if (++shiftedBits == 8)
+      {
+        shiftedBits = 0;
+        receive(shiftRegister);
+      }
+    }
+    clkLevel = value;
+  }
+}
+
+void St7565Emulator::spiTransfer(uint8_t toReceive, unsigned long microsPerByte)
+{
+  if (csLevel)
+  {
+    // chip not selected, the display ignores the byte
+    return;
+  }
+  counters.spiMicros += microsPerByte;
+  receive(toReceive);
+}
+
+void St7565Emulator::receive(uint8_t received)
+{
+  counters.bytes++;
+  if (cdLevel)
+  {
+    counters.dataBytes++;
+    data(received);
+  }
+  else
+  {
+    counters.commandBytes++;
+    command(received);
+  }
+}
+
+void St7565Emulator::command(uint8_t received)
+{
+  if (pendingParameterBytes > 0)
+  {
+    pendingParameterBytes--;
+    return;
+  }
+  switch (received & 0xF0)
+  {
+    case 0x00: // column address LSB
+      column = (column & 0xF0) | (received & 0x0F);
+      return;
+    case 0x10: // column address MSB
+      column = (column & 0x0F) | ((received & 0x0F) << 4);
+      return;
+    case 0x60: // page address LSB
+      page = (page & 0xF0) | (received & 0x0F);
+      counters.positionCalls++;
+      return;
+    case 0x70: // page address MSB
+      page = (page & 0x0F) | ((received & 0x0F) << 4);
+      return;
+  }
+  switch (received)
+  {
+    case 0x81: // contrast
+    case 0xC0: // LCD mapping control
+    case 0xF1: // COM end
+    case 0xF2: // partial display start
+    case 0xF3: // partial display end
+      pendingParameterBytes = 1;
+      return;
+  }
+  // all other commands do not influence the framebuffer
+}
+
+void St7565Emulator::data(uint8_t received)
+{
+  if (column < EMULATED_DISPLAY_WIDTH_IN_PX && page < EMULATED_DISPLAY_HEIGHT_IN_BYTES)
+  {
+    framebuffer[page][column] = received;
+  }
+  column++;
+  if (column >= EMULATED_DISPLAY_WIDTH_IN_PX)
+  {
+    column = 0;
+    page = (page + 1) % EMULATED_DISPLAY_HEIGHT_IN_BYTES;
+  }
+}
+
+bool St7565Emulator::getPixel(uint16_t x, uint8_t y)
+{
+  return (framebuffer[y / 8][x] >> (y % 8)) & 0x01;
+}
+
+uint8_t St7565Emulator::getPageByte(uint16_t xInPixel, uint8_t yInBytes)
+{
+  return framebuffer[yInBytes][xInPixel];
+}
+
+bool St7565Emulator::writePbm(const char *fileName)
+{
+  FILE *out = fopen(fileName, "w");
+  if (out == NULL)
+  {
+    return false;
+  }
+  fprintf(out, "P1\n%d %d\n", EMULATED_DISPLAY_WIDTH_IN_PX, EMULATED_DISPLAY_HEIGHT_IN_BYTES * 8);
+  for (uint8_t y = 0; y < EMULATED_DISPLAY_HEIGHT_IN_BYTES * 8; y++)
+  {
+    for (uint16_t x = 0; x < EMULATED_DISPLAY_WIDTH_IN_PX; x++)
+    {
+      fputc(getPixel(x, y) ? '1' : '0', out);
+      fputc(x % 35 == 34 ? '\n' : ' ', out);
+    }
+    fputc('\n', out);
+  }
+  return fclose(out) == 0;
+}
+
+void St7565Emulator::print(FILE *out)
+{
+  for (uint8_t y = 0; y < EMULATED_DISPLAY_HEIGHT_IN_BYTES * 8; y++)
+  {
+    for (uint16_t x = 0; x < EMULATED_DISPLAY_WIDTH_IN_PX; x++)
+    {
+      fputc(getPixel(x, y) ? '#' : '.', out);
+    }
+    fputc('\n', out);
+  }
+}
+
+St7565Counters St7565Emulator::getCounters()
+{
+  St7565Counters result = counters;
+  result.progmemReads = hostProgmemReads - progmemReadsAtReset;
+  return result;
+}
+
+void St7565Emulator::resetCounters()
+{
+  counters = St7565Counters();
+  progmemReadsAtReset = hostProgmemReads;
+}
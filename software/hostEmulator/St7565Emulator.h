@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+#ifndef ST7565_EMULATOR_H
+#define ST7565_EMULATOR_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define EMULATED_DISPLAY_WIDTH_IN_PX 240
+#define EMULATED_DISPLAY_HEIGHT_IN_BYTES 8
+
+/**
+ * Counts the traffic the display controller has seen.
+ */
+struct St7565Counters
+{
+  unsigned long bytes;           // all bytes clocked in while the chip was selected
+  unsigned long commandBytes;    // bytes clocked in while CD was low
+  unsigned long dataBytes;       // bytes clocked in while CD was high
+  unsigned long positionCalls;   // page address commands, i.e. calls to DogDisplay::position()
+  unsigned long chipSelects;     // CS transitions from high to low
+  unsigned long cdToggles;       // changes of the CD pin level
+  unsigned long spiMicros;       // estimated time spent clocking bytes at the configured SPI speed
+  unsigned long progmemReads;    // pgm_read_* calls
+};
+
+/**
+ * Software model of the page/column address logic of the display controller.
+ *
+ * Pin writes and SPI bytes are fed in from the Arduino and SPI stubs.
+ * Data bytes are written into a 240x64 pixel framebuffer at the current page and column,
+ * the column auto-increments after each data byte.
+ * Software SPI is decoded from the SI and CLK pin writes (SPI mode 3, MSB first).
+ */
+class St7565Emulator
+{
+  public:
+  /**
+   * Tells the emulator which Arduino pins are connected to which display pins.
+   */
+  void connect(uint8_t csPin, uint8_t cdPin, uint8_t siPin, uint8_t clkPin);
+
+  /**
+   * Called for each digitalWrite.
+   */
+  void pinWrite(uint8_t pin, uint8_t value);
+
+  /**
+   * Called for each byte transferred via hardware SPI.
+   *
+   * @param toReceive the transferred byte
+   * @param microsPerByte how long the transfer takes at the configured SPI speed
+   */
+  void spiTransfer(uint8_t toReceive, unsigned long microsPerByte);
+
+  /**
+   * Returns the pixel at the given position, true if set.
+   */
+  bool getPixel(uint16_t x, uint8_t y);
+
+  /**
+   * Returns the raw framebuffer byte at the given page and column.
+   */
+  uint8_t getPageByte(uint16_t xInPixel, uint8_t yInBytes);
+
+  /**
+   * Writes the framebuffer as plain PBM (P1) image.
+   *
+   * @return true on success.
+   */
+  bool writePbm(const char *fileName);
+
+  /**
+   * Prints the framebuffer as ASCII art.
+   */
+  void print(FILE *out);
+
+  St7565Counters getCounters();
+  void resetCounters();
+
+  private:
+  uint8_t framebuffer[EMULATED_DISPLAY_HEIGHT_IN_BYTES][EMULATED_DISPLAY_WIDTH_IN_PX] = {};
+  uint8_t csPin = 0xFF;
+  uint8_t cdPin = 0xFF;
+  uint8_t siPin = 0xFF;
+  uint8_t clkPin = 0xFF;
+  uint8_t csLevel = 1;
+  uint8_t cdLevel = 0;
+  uint8_t siLevel = 0;
+  uint8_t clkLevel = 1;
+  uint8_t shiftRegister = 0;
+  uint8_t shiftedBits = 0;
+  uint16_t column = 0;
+  uint8_t page = 0;
+  uint8_t pendingParameterBytes = 0;
+  St7565Counters counters = {};
+  unsigned long progmemReadsAtReset = 0;
+
+  void receive(uint8_t received);
+  void command(uint8_t received);
+  void data(uint8_t received);
+};
+
+extern St7565Emulator hostDisplayEmulator;
+
+#endif
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Minimal host replacement for the Arduino core, just enough to compile the sketch sources.
+// Pin writes are passed on to the display controller emulator, time is simulated.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+#ifndef F_CPU
+#define F_CPU 8000000UL
+#endif
+
+// the type of strings in program memory which print() sends, e.g. F("stats:ok;")
+class __FlashStringHelper;
+#define F(string) (reinterpret_cast<const __FlashStringHelper *>(PSTR(string)))
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef uint16_t word;
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+static const uint8_t MOSI = 11;
+static const uint8_t MISO = 12;
+static const uint8_t SCK = 13;
+
+/**
+ * Host replacement for an AVR port output register.
+ * Setting and clearing bits is passed on to the display controller emulator as pin writes,
+ * so that direct port access can be emulated like digitalWrite.
+ */
+class HostPortRegister
+{
+  public:
+  uint8_t port;    // the number of the port, as returned by digitalPinToPort
+  uint8_t value;   // the current output levels of the pins of the port
+
+  HostPortRegister &operator|=(uint8_t mask) { write(value | mask); return *this; }
+  HostPortRegister &operator&=(uint8_t mask) { write(value & mask); return *this; }
+
+  private:
+  void write(uint8_t newValue);
+};
+
+// the type of the port output registers, see DogDisplay.h
+#define PORT_REGISTER_TYPE HostPortRegister
+
+// The pin to port mapping of the ATmega328P based boards
+#define NOT_A_PORT 0
+#define PB 2
+#define PC 3
+#define PD 4
+
+uint8_t digitalPinToPort(uint8_t pin);
+uint8_t digitalPinToBitMask(uint8_t pin);
+HostPortRegister *portOutputRegister(uint8_t port);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+unsigned long millis();
+unsigned long micros();
+void yield();
+
+/**
+ * Advances the simulated time by the given number of microseconds.
+ */
+void hostAdvanceMicros(unsigned long us);
+
+/**
+ * Sets the value which analogRead() returns for all pins.
+ */
+void hostSetAnalogValue(int value);
+
+/**
+ * The subset of the Arduino String class used by the sketch.
+ */
+class String
+{
+  public:
+  String(const char *cstr = "") : value(cstr) {}
+  String(const std::string &str) : value(str) {}
+  explicit String(char c) : value(1, c) {}
+
+  unsigned int length() const { return value.length(); }
+  char charAt(unsigned int index) const { return index < value.length() ? value[index] : 0; }
+  char operator[](unsigned int index) const { return charAt(index); }
+  const char *c_str() const { return value.c_str(); }
+  bool startsWith(const String &prefix) const { return value.compare(0, prefix.value.length(), prefix.value) == 0; }
+  String substring(unsigned int from) const { return from < value.length() ? String(value.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const { return from < value.length() ? String(value.substr(from, to - from)) : String(); }
+  long toInt() const { return atol(value.c_str()); }
+  bool operator==(const String &other) const { return value == other.value; }
+  bool operator!=(const String &other) const { return value != other.value; }
+  String &operator+=(const String &other) { value += other.value; return *this; }
+  String operator+(const String &other) const { return String(value + other.value); }
+
+  private:
+  std::string value;
+};
+
+// Size of the receive buffers of HardwareSerial and SoftwareSerial, both hold at most SERIAL_RX_BUFFER_SIZE - 1 bytes
+#define SERIAL_RX_BUFFER_SIZE 64
+
+/**
+ * The subset of the Arduino HardwareSerial class used by the sketch.
+ * It shares the receive queue and the written bytes with SoftwareSerial, see SoftwareSerial.h.
+ */
+class HardwareSerial
+{
+  public:
+  void begin(unsigned long speed);
+  int available();
+  int read();
+  size_t write(uint8_t byte);
+  size_t write(const char *str);
+  size_t print(const __FlashStringHelper *str);
+  size_t print(unsigned long value);
+};
+
+extern HardwareSerial Serial;
+
+#define min(a,b) ((a)<(b)?(a):(b))
+#define max(a,b) ((a)>(b)?(a):(b))
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+
+#endif
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#include <Arduino.h>
+
+#define SPI_CLOCK_DIV2 0x04
+#define SPI_CLOCK_DIV4 0x00
+#define SPI_CLOCK_DIV8 0x05
+#define SPI_CLOCK_DIV16 0x01
+#define SPI_CLOCK_DIV32 0x06
+#define SPI_CLOCK_DIV64 0x02
+#define SPI_CLOCK_DIV128 0x03
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+/**
+ * Host replacement for the Arduino hardware SPI.
+ * Every transferred byte is passed on to the display controller emulator.
+ */
+class SPIClass
+{
+  public:
+  void begin();
+  void end();
+  void setBitOrder(uint8_t bitOrder);
+  void setDataMode(uint8_t dataMode);
+  void setClockDivider(uint8_t clockDivider);
+  uint8_t transfer(uint8_t data);
+
+  /**
+   * Returns by how much the CPU clock is divided to obtain the SPI clock.
+   */
+  uint8_t getClockDivision();
+
+  private:
+  uint8_t clockDivider = SPI_CLOCK_DIV4;
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+#ifndef HOST_SOFTWARE_SERIAL_H
+#define HOST_SOFTWARE_SERIAL_H
+
+#include <Arduino.h>
+
+/**
+ * Host replacement for the Arduino SoftwareSerial library.
+ * Received bytes are fed in by the host emulator via hostSerialInput(),
+ * written bytes are collected and can be fetched via hostSerialOutput().
+ */
+class SoftwareSerial
+{
+  public:
+  SoftwareSerial(uint8_t receivePin, uint8_t transmitPin);
+  void begin(long speed);
+  int available();
+  int read();
+  bool overflow();
+  size_t write(uint8_t byte);
+  size_t write(const char *str);
+  size_t print(const __FlashStringHelper *str);
+  size_t print(unsigned long value);
+};
+
+/**
+ * Appends bytes to the receive queue of all SoftwareSerial instances and of Serial.
+ */
+void hostSerialInput(const char *bytes);
+
+/**
+ * Appends bytes which may contain zero bytes to the receive queue of all SoftwareSerial instances and of Serial.
+ */
+void hostSerialInput(const char *bytes, size_t length);
+
+/**
+ * Returns and clears all bytes written to SoftwareSerial instances and to Serial since the last call.
+ */
+String hostSerialOutput();
+
+#endif
@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+#ifndef HOST_INTERRUPT_H
+#define HOST_INTERRUPT_H
+
+#include <avr/io.h>
+
+// No interrupts are emulated, cli() and sei() only switch the I bit in SREG.
+
+#define cli() (SREG &= ~0x80)
+#define sei() (SREG |= 0x80)
+
+#endif
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+#ifndef HOST_IO_H
+#define HOST_IO_H
+
+#include <stdint.h>
+
+// The subset of the AVR registers used by the sketch.
+// Writing SPDR passes the byte on to the display controller emulator,
+// advances the simulated time by the duration of the transfer and sets the SPIF flag in SPSR.
+
+#define _BV(bit) (1 << (bit))
+
+#define SPIF 7
+
+/**
+ * Host replacement for the SPI data register.
+ */
+class HostSpiDataRegister
+{
+  public:
+  HostSpiDataRegister &operator=(uint8_t data);
+};
+
+extern HostSpiDataRegister SPDR;
+extern uint8_t SPSR;
+extern uint8_t SREG;
+
+#endif
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+#ifndef HOST_PGMSPACE_H
+#define HOST_PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+
+// On the host, there is no separate program memory, so PGM reads are plain reads.
+// Every read is counted so the emulator can report how much flash traffic a render causes.
+
+extern unsigned long hostProgmemReads;
+
+#define PROGMEM
+
+#define pgm_read_byte(address) (hostProgmemReads++, *(const uint8_t *)(address))
+#define pgm_read_word(address) (hostProgmemReads++, *(const uint16_t *)(address))
+#define pgm_read_ptr(address) (hostProgmemReads++, *(void * const *)(address))
+
+#define PSTR(string) (string)
+#define strlen_P(string) strlen(string)
+#define memcmp_P(memory, string, length) memcmp(memory, string, length)
+
+#endif
@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+#ifndef HOST_SLEEP_H
+#define HOST_SLEEP_H
+
+#define SLEEP_MODE_IDLE 0
+
+#define set_sleep_mode(mode)
+#define sleep_enable()
+#define sleep_disable()
+
+/**
+ * Sleeps until the next interrupt, i.e. advances the simulated time to the next overflow of the millis() timer, 
+ * which happens every 1024 us.
+ */
+void sleep_cpu();
+
+#endif
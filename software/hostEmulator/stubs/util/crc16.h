@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2022 Thomas Fox
+ *
+ * This file is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2
+ * as published by the Free Software Foundation.
+ */
+#ifndef HOST_CRC16_H
+#define HOST_CRC16_H
+
+#include <stdint.h>
+
+// C equivalents of the avr-libc CRC update functions, as given in the avr-libc documentation
+
+static inline uint16_t _crc_ccitt_update(uint16_t crc, uint8_t data)
+{
+  data ^= (uint8_t) (crc & 0xFF);
+  data ^= data << 4;
+  return ((((uint16_t) data << 8) | (crc >> 8)) ^ (uint8_t) (data >> 4) ^ ((uint16_t) data << 3));
+}
+
+static inline uint8_t _crc8_ccitt_update(uint8_t inCrc, uint8_t inData)
+{
+  uint8_t data = inCrc ^ inData;
+  for (uint8_t i = 0; i < 8; i++)
+  {
+    if ((data & 0x80) != 0)
+    {
+      data <<= 1;
+      data ^= 0x07;
+    }
+    else
+    {
+      data <<= 1;
+    }
+  }
+  return data;
+}
+
+#endif